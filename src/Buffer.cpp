@@ -41,13 +41,16 @@ Buffer::Buffer(size_t len, const void *data)
     this->len = 0;
     this->size = 0;
     this->data = NULL;
+    this->external = false;
     setData(data, len);
 }
 
 
 Buffer::~Buffer()
 {
-    free(data);
+    if (!external) {
+        free(data);
+    }
 }
 
 
@@ -67,14 +70,17 @@ Buffer &Buffer::operator+=(const Buffer &copy)
 
 void Buffer::setLength(size_t len)
 {
-    if (len > size) {
+    if (len > size || external) {
         void *tmp = data;
 
         /* Align to 32-byte boundary for AVX. */
         data = memalign(32, len);
 
-        memcpy(data, tmp, this->len);
-        free(tmp);
+        memcpy(data, tmp, this->len < len ? this->len : len);
+        if (!external) {
+            free(tmp);
+        }
+        external = false;
         size = len;
     }
     this->len = len;
@@ -88,6 +94,18 @@ void Buffer::setData(const void *data, size_t len)
 }
 
 
+void Buffer::setExternalData(const void *data, size_t len)
+{
+    if (!external) {
+        free(this->data);
+    }
+    this->data = const_cast<void*>(data);
+    this->len = len;
+    this->size = len;
+    this->external = true;
+}
+
+
 void Buffer::appendData(const void *data, size_t len)
 {
     size_t offset = this->len;
@@ -35,6 +35,8 @@ protected:
     size_t len;
     size_t size;
     void *data;
+    // The data belongs to someone else, see setExternalData()
+    bool external;
 
 public:
     Buffer(const Buffer& copy);
@@ -48,6 +50,12 @@ public:
     void setData(const void *data, size_t len);
     void appendData(const void *data, size_t len);
 
+    // Points the buffer to data owned by the caller, without copying it.
+    // The data must stay valid while the buffer uses it, and is never
+    // written to: changing the length or the data of the buffer first
+    // moves it to memory of its own.
+    void setExternalData(const void *data, size_t len);
+
     size_t getLength();
     void *getData();
 };
@@ -35,6 +35,24 @@ CicEqualizer::CicEqualizer(size_t nbCarriers, size_t spacing, int R) :
     PDEBUG("CicEqualizer::CicEqualizer(%zu, %zu, %i) @ %p\n",
             nbCarriers, spacing, R, this);
 
+    switch (nbCarriers) {
+    case 1536:
+        myEqualizeSymbol = equalizeSymbol<1536>;
+        break;
+    case 384:
+        myEqualizeSymbol = equalizeSymbol<384>;
+        break;
+    case 192:
+        myEqualizeSymbol = equalizeSymbol<192>;
+        break;
+    case 768:
+        myEqualizeSymbol = equalizeSymbol<768>;
+        break;
+    default:
+        throw std::runtime_error(
+                "CicEqualizer::CicEqualizer nb of carriers invalid!");
+    }
+
     myFilter = new float[nbCarriers];
     const int M = 1;
     const int N = 4;
@@ -67,6 +85,16 @@ CicEqualizer::~CicEqualizer()
 }
 
 
+template<size_t nbCarriers>
+void CicEqualizer::equalizeSymbol(const float* filter, const complexf* in,
+        complexf* out)
+{
+    for (size_t j = 0; j < nbCarriers; ++j) {
+        out[j] = in[j] * filter[j];
+    }
+}
+
+
 int CicEqualizer::process(Buffer* const dataIn, Buffer* dataOut)
 {
     PDEBUG("CicEqualizer::process(dataIn: %p, dataOut: %p)\n",
@@ -85,10 +113,8 @@ int CicEqualizer::process(Buffer* const dataIn, Buffer* dataOut)
                 "CicEqualizer::process input size not valid!");
     }
 
-    for (size_t i = 0; i < sizeOut; ) {
-        for (size_t j = 0; j < myNbCarriers; ++j, ++i) {
-            out[i] = in[i] * myFilter[j];
-        }
+    for (size_t i = 0; i < sizeOut; i += myNbCarriers) {
+        myEqualizeSymbol(myFilter, &in[i], &out[i]);
     }
 
     return sizeOut;
@@ -55,6 +55,14 @@ protected:
     size_t myNbCarriers;
     size_t mySpacing;
     float* myFilter;
+
+    // Equalizes one OFDM symbol, instantiated for the carriers of each
+    // mode
+    void (*myEqualizeSymbol)(const float* filter, const complexf* in,
+            complexf* out);
+    template<size_t nbCarriers>
+    static void equalizeSymbol(const float* filter, const complexf* in,
+            complexf* out);
 };
 
 
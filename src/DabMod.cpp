@@ -35,6 +35,14 @@
 #include "DabModulator.h"
 #include "InputMemory.h"
 #include "OutputFile.h"
+#include "FormatConverter.h"
+#include "FrequencyShifter.h"
+#include "EnsembleCombiner.h"
+#include "EnsembleHost.h"
+#include "Numa.h"
+#include "OutputTee.h"
+#include "OutputTcp.h"
+#include "SplitFrame.h"
 #if defined(HAVE_OUTPUT_UHD)
 #   include "OutputUHD.h"
 #endif
@@ -48,9 +56,13 @@
 #include <boost/property_tree/ini_parser.hpp>
 #include <complex>
 #include <string>
+#include <sstream>
+#include <vector>
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdexcept>
@@ -167,8 +179,18 @@ int main(int argc, char* argv[])
 
     std::string outputName;
     int useFileOutput = 0;
+    SampleFormat outputFormat = FORMAT_COMPLEXF;
+    bool outputDither = false;
+
+    // Additional file outputs getting a copy of every frame
+    std::vector<std::string> teeFilenames;
+    std::vector<size_t> teeQueueSizes;
+    std::vector<TeePolicy> teePolicies;
 //#if defined(HAVE_OUTPUT_UHD)
     int useUHDOutput = 0;
+    int useSplitOutput = 0;
+    unsigned splitPort = 0;
+    SplitRole splitRole = SPLIT_NONE;
 //#endif
 
     uint64_t frame = 0;
@@ -180,6 +202,21 @@ int main(int argc, char* argv[])
     Buffer data;
 
     std::string filterTapsFilename = "";
+    bool useFrequencyShift = false;
+    double frequencyOffset = 0.0;
+
+    // Additional ensembles of the combiner, the first one uses the
+    // regular input
+    std::vector<std::string> ensembleSources;
+    std::vector<double> ensembleOffsets;
+    std::vector<std::string> hostedSources;
+    std::vector<std::string> hostedOutputs;
+    std::vector<std::string> hostedCpus;
+    std::vector<int> hostedNumaNodes;
+    int numaNode = -1;
+    unsigned statsInterval = 10;
+    std::vector<InputFileReader*> ensembleReaders;
+    std::vector<Buffer*> ensembleData;
 
     // Two configuration sources exist: command line and (new) INI file
     bool use_configuration_cmdline = false;
@@ -198,6 +235,7 @@ int main(int argc, char* argv[])
 
     Flowgraph* flowgraph = NULL;
     DabModulator* modulator = NULL;
+    EnsembleCombiner* combiner = NULL;
     InputMemory* input = NULL;
     ModOutput* output = NULL;
 
@@ -205,6 +243,13 @@ int main(int argc, char* argv[])
 
     Logger logger;
     InputFileReader inputFileReader(logger);
+    InputMmapReader inputMmapReader(logger);
+    bool useMmap = true;
+    bool useIndex = false;
+    uint64_t startFrame = 0;
+    std::string startTime;
+    EtiCrcPolicy crcPolicy = ETI_CRC_LOG;
+    InputTcpReader inputTcpReader(logger);
 #if defined(HAVE_INPUT_ZEROMQ)
     InputZeroMQReader inputZeroMQReader(logger);
 #endif
@@ -375,6 +420,17 @@ int main(int argc, char* argv[])
 
         inputTransport = pt.get("input.transport", "file");
         inputName = pt.get("input.source", "/dev/stdin");
+        useMmap = (pt.get("input.mmap", 1) == 1);
+        useIndex = (pt.get("input.index", 0) == 1);
+        startFrame = pt.get<uint64_t>("input.start_frame", 0);
+        startTime = pt.get("input.start_time", "");
+        try {
+            crcPolicy = EtiReader::parseCrcPolicy(pt.get("input.crc", "log"));
+        }
+        catch (std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            goto END_MAIN;
+        }
 
         // log parameters:
         if (pt.get("log.syslog", 0) == 1) {
@@ -417,15 +473,125 @@ int main(int argc, char* argv[])
             }
         }
 
+        // Multi-ensemble combiner
+        if (pt.get("combiner.enabled", 0) == 1) {
+            size_t nbEnsembles = pt.get("combiner.ensembles", 0);
+            if (nbEnsembles == 0) {
+                std::cerr << "       Combiner enabled, but no ensembles defined.\n";
+                goto END_MAIN;
+            }
+            for (size_t i = 1; i <= nbEnsembles; ++i) {
+                std::stringstream section;
+                section << "ensemble" << i;
+                try {
+                    ensembleSources.push_back(
+                            pt.get<std::string>(section.str() + ".source"));
+                }
+                catch (std::exception &e) {
+                    std::cerr << "Error: " << e.what() << "\n";
+                    std::cerr << "       Combiner enabled, but no source defined for " <<
+                        section.str() << ".\n";
+                    goto END_MAIN;
+                }
+                ensembleOffsets.push_back(
+                        pt.get<double>(section.str() + ".offset", 0.0));
+            }
+            inputName = ensembleSources[0];
+        }
+
+        // Multi-ensemble supervisor
+        if (pt.get("supervisor.enabled", 0) == 1) {
+            if (!ensembleSources.empty()) {
+                std::cerr << "       The supervisor and the combiner cannot be used together.\n";
+                goto END_MAIN;
+            }
+            size_t nbEnsembles = pt.get("supervisor.ensembles", 0);
+            if (nbEnsembles == 0) {
+                std::cerr << "       Supervisor enabled, but no ensembles defined.\n";
+                goto END_MAIN;
+            }
+            for (size_t i = 1; i <= nbEnsembles; ++i) {
+                std::stringstream section;
+                section << "ensemble" << i;
+                try {
+                    hostedSources.push_back(
+                            pt.get<std::string>(section.str() + ".source"));
+                    hostedOutputs.push_back(
+                            pt.get<std::string>(section.str() + ".output"));
+                }
+                catch (std::exception &e) {
+                    std::cerr << "Error: " << e.what() << "\n";
+                    std::cerr << "       Supervisor enabled, but no source or output defined for " <<
+                        section.str() << ".\n";
+                    goto END_MAIN;
+                }
+                hostedCpus.push_back(
+                        pt.get<std::string>(section.str() + ".cpus", ""));
+                hostedNumaNodes.push_back(
+                        pt.get(section.str() + ".numa_node", -1));
+            }
+            statsInterval = pt.get("supervisor.statsinterval", 10);
+        }
+
+        // NUMA placement
+        std::string numa_node = pt.get("numa.node", "");
+        if (numa_node == "auto") {
+            std::string device = pt.get("numa.device", "");
+            numaNode = numaDeviceNode(device);
+            if (numaNode < 0) {
+                std::cerr << "       NUMA node of device '" << device <<
+                    "' unknown, the modulator is not placed.\n";
+            }
+        }
+        else if (numa_node != "") {
+            try {
+                numaNode = pt.get<int>("numa.node");
+            }
+            catch (std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                std::cerr << "       NUMA node must be a number or auto.\n";
+                goto END_MAIN;
+            }
+        }
+
+        // Frequency shift options
+        if (pt.get("freqshift.enabled", 0) == 1) {
+            useFrequencyShift = true;
+            frequencyOffset = pt.get<double>("freqshift.offset", 0.0);
+        }
+
         // Output options
         std::string output_selected;
         try {
              output_selected = pt.get<std::string>("output.output");
         }
         catch (std::exception &e) {
-            std::cerr << "Error: " << e.what() << "\n";
-            std::cerr << "       Configuration does not specify output\n";
-            goto END_MAIN;
+            // The ensembles of the supervisor have their own outputs
+            if (hostedSources.empty()) {
+                std::cerr << "Error: " << e.what() << "\n";
+                std::cerr << "       Configuration does not specify output\n";
+                goto END_MAIN;
+            }
+        }
+
+        size_t nbTees = pt.get("output.tee", 0);
+        for (size_t i = 1; i <= nbTees; ++i) {
+            std::stringstream section;
+            section << "tee" << i;
+            try {
+                teeFilenames.push_back(
+                        pt.get<std::string>(section.str() + ".filename"));
+                teeQueueSizes.push_back(
+                        pt.get<size_t>(section.str() + ".queue", 8));
+                teePolicies.push_back(OutputTee::parsePolicy(
+                            pt.get<std::string>(section.str() + ".policy", "drop")));
+            }
+            catch (std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                std::cerr << "       Configuration of " << section.str() <<
+                    " output is not valid.\n";
+                goto END_MAIN;
+            }
         }
 
         if (output_selected == "file") {
@@ -437,8 +603,28 @@ int main(int argc, char* argv[])
                 std::cerr << "       Configuration does not specify file name for file output\n";
                 goto END_MAIN;
             }
+            try {
+                outputFormat = FormatConverter::parseFormat(
+                        pt.get("fileoutput.format", "complexf"));
+            }
+            catch (std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                goto END_MAIN;
+            }
+            outputDither = pt.get("fileoutput.dither", 0);
             useFileOutput = 1;
         }
+        else if (output_selected == "split") {
+            try {
+                splitPort = pt.get<unsigned>("splitoutput.listen");
+            }
+            catch (std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                std::cerr << "       Configuration does not specify port for split output\n";
+                goto END_MAIN;
+            }
+            useSplitOutput = 1;
+        }
 #if defined(HAVE_OUTPUT_UHD)
         else if (output_selected == "uhd") {
             outputuhd_conf.device = pt.get("uhdoutput.device", "");
@@ -515,6 +701,20 @@ int main(int argc, char* argv[])
             }
 
 
+            try {
+                outputFormat = FormatConverter::parseFormat(
+                        pt.get("uhdoutput.format", "complexf"));
+            }
+            catch (std::exception &e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                goto END_MAIN;
+            }
+            if (outputFormat == FORMAT_U8) {
+                std::cerr << "       UHD output does not support u8 samples.\n";
+                goto END_MAIN;
+            }
+            outputDither = pt.get("uhdoutput.dither", 0);
+
             outputuhd_conf.refclk_src = pt.get("uhdoutput.refclk_source", "int");
             outputuhd_conf.pps_src = pt.get("uhdoutput.pps_source", "int");
             outputuhd_conf.pps_polarity = pt.get("uhdoutput.pps_polarity", "pos");
@@ -535,6 +735,8 @@ int main(int argc, char* argv[])
             useUHDOutput = 1;
         }
 #endif
+        else if (!hostedSources.empty() && output_selected == "") {
+        }
         else {
             std::cerr << "Error: Invalid output defined.\n";
             goto END_MAIN;
@@ -611,16 +813,48 @@ int main(int argc, char* argv[])
         goto END_MAIN;
     }
 
-    if (!useFileOutput && !useUHDOutput) {
+    if (!useFileOutput && !useUHDOutput && !useSplitOutput &&
+            hostedSources.empty()) {
         logger.level(error) << "Output not specified";
         fprintf(stderr, "Must specify output !");
         goto END_MAIN;
     }
 
+    if (useSplitOutput) {
+        // The central instance only does the channel coding
+        if (inputTransport == "tcp" || !ensembleSources.empty() ||
+                useFrequencyShift || outputFormat != FORMAT_COMPLEXF ||
+                !teeFilenames.empty()) {
+            fprintf(stderr, "Error, the split output cannot be combined with "
+                    "a tcp input, the combiner, the frequency shift, the "
+                    "output format or additional outputs!\n");
+            ret = -1;
+            goto END_MAIN;
+        }
+        splitRole = SPLIT_CENTRAL;
+    }
+
     // Print settings
     fprintf(stderr, "Input\n");
     fprintf(stderr, "  Type: %s\n", inputTransport.c_str());
-    fprintf(stderr, "  Source: %s\n", inputName.c_str());
+    if (!hostedSources.empty()) {
+        fprintf(stderr, "  Supervisor: %zu ensembles\n", hostedSources.size());
+        for (size_t i = 0; i < hostedSources.size(); ++i) {
+            fprintf(stderr, "  Source: %s, output %s, CPUs %s\n",
+                    hostedSources[i].c_str(), hostedOutputs[i].c_str(),
+                    hostedCpus[i].empty() ? "all" : hostedCpus[i].c_str());
+        }
+    }
+    else if (ensembleSources.empty()) {
+        fprintf(stderr, "  Source: %s\n", inputName.c_str());
+    }
+    else {
+        fprintf(stderr, "  Combiner: %zu ensembles\n", ensembleSources.size());
+        for (size_t i = 0; i < ensembleSources.size(); ++i) {
+            fprintf(stderr, "  Source: %s, offset %.0f Hz\n",
+                    ensembleSources[i].c_str(), ensembleOffsets[i]);
+        }
+    }
     fprintf(stderr, "Output\n");
 #if defined(HAVE_OUTPUT_UHD)
     if (useUHDOutput) {
@@ -638,6 +872,17 @@ int main(int argc, char* argv[])
 #endif
         fprintf(stderr, "  Name: %s\n", outputName.c_str());
     }
+    else if (useSplitOutput) {
+        fprintf(stderr, " Split frames to OFDM heads\n"
+                        "  Port: %u\n", splitPort);
+    }
+    fprintf(stderr, "  Format: %s%s\n", FormatConverter::formatName(outputFormat),
+            outputDither ? ", dithered" : "");
+    for (size_t i = 0; i < teeFilenames.size(); ++i) {
+        fprintf(stderr, "  Copy to: %s, queue %zu, %s\n",
+                teeFilenames[i].c_str(), teeQueueSizes[i],
+                teePolicies[i] == TEE_BLOCK ? "blocking" : "dropping");
+    }
     fprintf(stderr, "  Sampling rate: ");
     if (outputRate > 1000) {
         if (outputRate > 1000000) {
@@ -649,16 +894,130 @@ int main(int argc, char* argv[])
         fprintf(stderr, "%zu Hz\n", outputRate);
     }
 
+    if (numaNode >= 0) {
+        // Everything created from here on, the worker threads of the
+        // blocks and of the output and the buffers, stays on the node
+        fprintf(stderr, "NUMA node: %d\n", numaNode);
+        if (!numaBindThread(numaNode)) {
+            fprintf(stderr, "Warning: unable to place the modulator on NUMA "
+                    "node %d\n", numaNode);
+        }
+    }
+
+    if (!hostedSources.empty()) {
+        // Each ensemble runs in its own thread with its own input and
+        // output, this thread only supervises them
+        EnsembleHost host(modconf, rc, logger, outputRate, clockRate,
+                dabMode, gainMode, amplitude, filterTapsFilename, loop);
+        host.setCrcPolicy(crcPolicy);
+        try {
+            for (size_t i = 0; i < hostedSources.size(); ++i) {
+                host.addEnsemble(hostedSources[i], hostedOutputs[i],
+                        parseCpuList(hostedCpus[i]), hostedNumaNodes[i]);
+            }
+        }
+        catch (std::exception& e) {
+            fprintf(stderr, "Error: %s\n", e.what());
+            ret = -1;
+            goto END_MAIN;
+        }
+        host.enrol_at(*rc);
+        host.start();
+
+        unsigned long seconds = 0;
+        while (running && host.running() > 0) {
+            sleep(1);
+            ++seconds;
+            if (statsInterval > 0 && (seconds % statsInterval) == 0) {
+                fprintf(stderr, "Supervisor:\n");
+                host.printStats();
+            }
+
+            if (rc && rc->fault_detected()) {
+                fprintf(stderr,
+                        "Detected Remote Control fault, restarting it\n");
+                rc->restart();
+            }
+        }
+        host.stop();
+        fprintf(stderr, "Supervisor:\n");
+        host.printStats();
+        frame = host.frames();
+        goto END_MAIN;
+    }
+
     if (inputTransport == "file") {
-        // Opening ETI input file
-        if (inputFileReader.Open(inputName, loop) == -1) {
-            fprintf(stderr, "Unable to open input file!\n");
-            logger.level(error) << "Unable to open input file!";
+        // Regular files are mapped, pipes, devices and compressed files
+        // are read
+        struct stat inputStat;
+        if (useMmap && stat(inputName.c_str(), &inputStat) == 0 &&
+                S_ISREG(inputStat.st_mode) && inputStat.st_size > 0 &&
+                InputDecompressor::Identify(inputName) == COMPRESSION_NONE) {
+            if (inputMmapReader.Open(inputName, loop) == -1) {
+                fprintf(stderr, "Unable to open input file!\n");
+                logger.level(error) << "Unable to open input file!";
+                ret = -1;
+                goto END_MAIN;
+            }
+
+            inputReader = &inputMmapReader;
+
+            if (useIndex && inputMmapReader.UseIndex(true) == -1) {
+                ret = -1;
+                goto END_MAIN;
+            }
+            if (startFrame > 0 && inputMmapReader.Seek(startFrame) == -1) {
+                fprintf(stderr, "Input file has no frame %lu!\n",
+                        startFrame);
+                ret = -1;
+                goto END_MAIN;
+            }
+            if (!startTime.empty()) {
+                struct tm start;
+                memset(&start, 0, sizeof(start));
+                char* end = strptime(startTime.c_str(), "%Y-%m-%d %H:%M:%S",
+                        &start);
+                if (end == NULL || *end != '\0') {
+                    fprintf(stderr, "Invalid start time %s!\n",
+                            startTime.c_str());
+                    ret = -1;
+                    goto END_MAIN;
+                }
+                if (inputMmapReader.SeekTime(timegm(&start)) == -1) {
+                    fprintf(stderr, "Input file has no frame at %s!\n",
+                            startTime.c_str());
+                    ret = -1;
+                    goto END_MAIN;
+                }
+            }
+        }
+        else if (useIndex || startFrame > 0 || !startTime.empty()) {
+            fprintf(stderr, "Input file cannot be indexed, it is not an "
+                    "uncompressed regular file or mmap is disabled!\n");
             ret = -1;
             goto END_MAIN;
         }
+        else {
+            // Opening ETI input file
+            if (inputFileReader.Open(inputName, loop) == -1) {
+                fprintf(stderr, "Unable to open input file!\n");
+                logger.level(error) << "Unable to open input file!";
+                ret = -1;
+                goto END_MAIN;
+            }
 
-        inputReader = &inputFileReader;
+            inputReader = &inputFileReader;
+        }
+    }
+    else if (inputTransport == "tcp") {
+        // Split frames from a central instance, this is an OFDM head
+        if (inputTcpReader.Open(inputName) == -1) {
+            fprintf(stderr, "Unable to connect to %s!\n", inputName.c_str());
+            ret = -1;
+            goto END_MAIN;
+        }
+        inputReader = &inputTcpReader;
+        splitRole = SPLIT_HEAD;
     }
     else if (inputTransport == "zeromq") {
 #if !defined(HAVE_INPUT_ZEROMQ)
@@ -677,14 +1036,50 @@ int main(int argc, char* argv[])
         goto END_MAIN;
     }
 
+    if (!ensembleSources.empty() && inputTransport != "file") {
+        fprintf(stderr, "Error, the combiner only supports the file input transport!\n");
+        ret = -1;
+        goto END_MAIN;
+    }
+    for (size_t i = 1; i < ensembleSources.size(); ++i) {
+        InputFileReader* reader = new InputFileReader(logger);
+        ensembleReaders.push_back(reader);
+        if (reader->Open(ensembleSources[i], loop) == -1) {
+            fprintf(stderr, "Unable to open input file %s!\n",
+                    ensembleSources[i].c_str());
+            logger.level(error) << "Unable to open input file!";
+            ret = -1;
+            goto END_MAIN;
+        }
+        ensembleData.push_back(new Buffer(6144));
+    }
 
-    if (useFileOutput) {
+
+    if (useSplitOutput) {
+        try {
+            output = new OutputTcp(splitPort);
+        }
+        catch (std::exception& e) {
+            fprintf(stderr, "Error: %s\n", e.what());
+            ret = -1;
+            goto END_MAIN;
+        }
+    }
+    else if (useFileOutput) {
         // Opening COFDM output file
         output = new OutputFile(outputName);
     }
 #if defined(HAVE_OUTPUT_UHD)
     else if (useUHDOutput) {
-        amplitude /= 32000.0f;
+        // The modulator output peaks around 32000, scale it to the full
+        // range of the host sample format. sc16 needs no scaling.
+        if (outputFormat == FORMAT_COMPLEXF) {
+            amplitude /= 32000.0f;
+        }
+        else if (outputFormat == FORMAT_SC8) {
+            amplitude /= 256.0f;
+        }
+        outputuhd_conf.format = outputFormat;
         outputuhd_conf.sampleRate = outputRate;
         try {
             output = new OutputUHD(outputuhd_conf, logger);
@@ -698,16 +1093,93 @@ int main(int argc, char* argv[])
 #endif
 
     flowgraph = new Flowgraph();
-    data.setLength(6144);
+    data.setLength(splitRole == SPLIT_HEAD ? SPLIT_FRAME_MAX_SIZE : 6144);
     input = new InputMemory(&data);
-    modulator = new DabModulator(modconf, rc, logger, outputRate, clockRate,
-            dabMode, gainMode, amplitude, filterTapsFilename);
-    flowgraph->connect(input, modulator);
-    flowgraph->connect(modulator, output);
+    if (ensembleSources.empty()) {
+        modulator = new DabModulator(modconf, rc, logger, outputRate,
+                clockRate, dabMode, gainMode, amplitude, filterTapsFilename,
+                splitRole);
+        modulator->getEtiReader()->setCrcPolicy(crcPolicy);
+        flowgraph->connect(input, modulator);
+    }
+    else {
+        combiner = new EnsembleCombiner();
+        for (size_t i = 0; i < ensembleSources.size(); ++i) {
+            std::stringstream rcName;
+            rcName << "freqshift" << (i + 1);
+            FrequencyShifter* shifter;
+            try {
+                shifter = new FrequencyShifter(ensembleOffsets[i],
+                        outputRate, rcName.str());
+            }
+            catch (std::exception& e) {
+                fprintf(stderr, "Error: ensemble%zu: %s\n", i + 1, e.what());
+                ret = -1;
+                goto END_MAIN;
+            }
+            shifter->enrol_at(*rc);
+            std::stringstream rcSuffix;
+            rcSuffix << (i + 1);
+            DabModulator* ensemble = new DabModulator(modconf, rc, logger,
+                    outputRate, clockRate, dabMode, gainMode, amplitude,
+                    filterTapsFilename, SPLIT_NONE, rcSuffix.str());
+            ensemble->getEtiReader()->setCrcPolicy(crcPolicy);
+            combiner->addEnsemble(ensemble, shifter);
+        }
+        flowgraph->connect(input, combiner);
+        for (size_t i = 0; i < ensembleData.size(); ++i) {
+            flowgraph->connect(new InputMemory(ensembleData[i]), combiner);
+        }
+    }
+    {
+        ModPlugin* last = modulator;
+        if (combiner != NULL) {
+            last = combiner;
+        }
+        if (useFrequencyShift) {
+            FrequencyShifter* shifter;
+            try {
+                shifter = new FrequencyShifter(frequencyOffset, outputRate);
+            }
+            catch (std::exception& e) {
+                fprintf(stderr, "Error: %s\n", e.what());
+                ret = -1;
+                goto END_MAIN;
+            }
+            shifter->enrol_at(*rc);
+            flowgraph->connect(last, shifter);
+            last = shifter;
+        }
+        if (outputFormat != FORMAT_COMPLEXF) {
+            FormatConverter* converter =
+                new FormatConverter(outputFormat, outputDither);
+            flowgraph->connect(last, converter);
+            last = converter;
+        }
+        if (!teeFilenames.empty()) {
+            OutputTee* tee = new OutputTee(output);
+            flowgraph->connect(last, tee);
+            try {
+                for (size_t i = 0; i < teeFilenames.size(); ++i) {
+                    tee->addSink(new OutputFile(teeFilenames[i]),
+                            teeQueueSizes[i], teePolicies[i]);
+                }
+            }
+            catch (std::exception& e) {
+                fprintf(stderr, "Error: %s\n", e.what());
+                ret = -1;
+                goto END_MAIN;
+            }
+        }
+        else {
+            flowgraph->connect(last, output);
+        }
+    }
 
 #if defined(HAVE_OUTPUT_UHD)
     if (useUHDOutput) {
-        ((OutputUHD*)output)->setETIReader(modulator->getEtiReader());
+        ((OutputUHD*)output)->setETIReader(combiner != NULL ?
+                combiner->getEtiReader() : modulator->getEtiReader());
     }
 #endif
 
@@ -721,10 +1193,20 @@ int main(int argc, char* argv[])
             PDEBUG("*****************************************\n");
             PDEBUG("* Starting main loop\n");
             PDEBUG("*****************************************\n");
-            while ((framesize = inputReader->GetNextFrame(data.getData())) > 0) {
+            while ((framesize = inputReader->GetNextFrameBuffer(&data)) > 0) {
                 if (!running) {
                     break;
                 }
+                for (size_t i = 0; i < ensembleReaders.size(); ++i) {
+                    framesize = ensembleReaders[i]->GetNextFrame(
+                            ensembleData[i]->getData());
+                    if (framesize <= 0) {
+                        break;
+                    }
+                }
+                if (framesize <= 0) {
+                    break;
+                }
 
                 frame++;
 
@@ -769,6 +1251,13 @@ END_MAIN:
     fprintf(stderr, "\nCleaning flowgraph...\n");
     delete flowgraph;
 
+    for (size_t i = 0; i < ensembleReaders.size(); ++i) {
+        delete ensembleReaders[i];
+    }
+    for (size_t i = 0; i < ensembleData.size(); ++i) {
+        delete ensembleData[i];
+    }
+
     // Cif
     fprintf(stderr, "\nCleaning buffers...\n");
 
@@ -24,11 +24,13 @@
  */
 
 #include <string>
+#include <stdint.h>
+#include <string.h>
 
 #include "DabModulator.h"
 #include "PcDebug.h"
 
-#include "FrameMultiplexer.h"
+#include "MscEncoder.h"
 #include "PrbsGenerator.h"
 #include "BlockPartitioner.h"
 #include "QpskSymbolMapper.h"
@@ -42,10 +44,11 @@
 #include "GainControl.h"
 #include "GuardIntervalInserter.h"
 #include "Resampler.h"
-#include "ConvEncoder.h"
+#include "HalfBandInterpolator.h"
 #include "FIRFilter.h"
-#include "PuncturingEncoder.h"
-#include "TimeInterleaver.h"
+#include "PuncturedConvEncoder.h"
+#include "SplitFrameEncoder.h"
+#include "InputMemory.h"
 #include "TimestampDecoder.h"
 #include "RemoteControl.h"
 #include "Log.h"
@@ -57,7 +60,9 @@ DabModulator::DabModulator(
         Logger& logger,
         unsigned outputRate, unsigned clockRate,
         unsigned dabMode, GainMode gainMode, float factor,
-        std::string filterTapsFilename
+        std::string filterTapsFilename,
+        SplitRole splitRole,
+        std::string rcSuffix
         ) :
     ModCodec(ModFormat(1), ModFormat(0)),
     myLogger(logger),
@@ -66,10 +71,12 @@ DabModulator::DabModulator(
     myDabMode(dabMode),
     myGainMode(gainMode),
     myFactor(factor),
-    myEtiReader(EtiReader(modconf, myLogger)),
+    myEtiReader(modconf, myLogger, "etireader" + rcSuffix),
     myFlowgraph(NULL),
     myFilterTapsFilename(filterTapsFilename),
-    myRC(rc)
+    myRC(rc),
+    mySplitRole(splitRole),
+    myRcSuffix(rcSuffix)
 {
     PDEBUG("DabModulator::DabModulator(%u, %u, %u, %u) @ %p\n",
             outputRate, clockRate, dabMode, gainMode, this);
@@ -134,12 +141,259 @@ void DabModulator::setMode(unsigned mode)
 }
 
 
+bool DabModulator::scaleToOutputRate(size_t& spacing, size_t& nullSize,
+        size_t& symSize)
+{
+    const uint64_t rate = myOutputRate;
+
+    if (((mySpacing * rate) % 2048000) != 0 ||
+            ((myNullSize * rate) % 2048000) != 0 ||
+            ((mySymSize * rate) % 2048000) != 0) {
+        return false;
+    }
+
+    spacing = mySpacing * rate / 2048000;
+    nullSize = myNullSize * rate / 2048000;
+    symSize = mySymSize * rate / 2048000;
+
+    // The DC carrier must stay free
+    if (spacing <= myNbCarriers) {
+        return false;
+    }
+
+    // KISS FFT only has fast butterflies for radix 2, 3, 4 and 5
+    size_t n = spacing;
+    while (n % 2 == 0) n /= 2;
+    while (n % 3 == 0) n /= 3;
+    while (n % 5 == 0) n /= 5;
+
+    return n == 1;
+}
+
+
+void DabModulator::setupCoding(ModPlugin* cifPart)
+{
+    ////////////////////////////////////////////////////////////////
+    // CIF data initialisation
+    ////////////////////////////////////////////////////////////////
+    PrbsGenerator* cifPrbs = new PrbsGenerator(864 * 8, 0x110);
+    MscEncoder* cifMux = new MscEncoder(864 * 8,
+            myEtiReader.getSubchannels());
+
+    myFlowgraph->connect(cifPrbs, cifMux);
+
+    ////////////////////////////////////////////////////////////////
+    // Processing FIC
+    ////////////////////////////////////////////////////////////////
+    FicSource* fic = myEtiReader.getFic();
+    PrbsGenerator* ficPrbs = NULL;
+    PuncturedConvEncoder* ficConv = NULL;
+    ////////////////////////////////////////////////////////////////
+    // Data initialisation
+    ////////////////////////////////////////////////////////////////
+    myFicSizeIn = fic->getFramesize();
+
+    ////////////////////////////////////////////////////////////////
+    // Modules configuration
+    ////////////////////////////////////////////////////////////////
+
+    // Configuring FIC channel
+
+    PDEBUG("FIC:\n");
+    PDEBUG(" Framesize: %zu\n", fic->getFramesize());
+
+    // Configuring prbs generator
+    ficPrbs = new PrbsGenerator(myFicSizeIn, 0x110);
+
+    // Configuring convolutionnal and puncturing encoder
+    ficConv = new PuncturedConvEncoder();
+    std::vector<PuncturingRule*> rules = fic->get_rules();
+    std::vector<PuncturingRule*>::const_iterator rule;
+    for (rule = rules.begin(); rule != rules.end(); ++rule) {
+        PDEBUG(" Adding rule:\n");
+        PDEBUG("  Length: %zu\n", (*rule)->length());
+        PDEBUG("  Pattern: 0x%x\n", (*rule)->pattern());
+        ficConv->append_rule(*(*rule));
+    }
+    PDEBUG(" Adding tail\n");
+    ficConv->append_tail_rule(PuncturingRule(3, 0xcccccc));
+
+    myFlowgraph->connect(fic, ficPrbs);
+    myFlowgraph->connect(ficPrbs, ficConv);
+    myFlowgraph->connect(ficConv, cifPart);
+
+    ////////////////////////////////////////////////////////////////
+    // Configuring subchannels
+    ////////////////////////////////////////////////////////////////
+    std::vector<SubchannelSource*> subchannels =
+        myEtiReader.getSubchannels();
+    std::vector<SubchannelSource*>::const_iterator subchannel;
+    for (subchannel = subchannels.begin();
+            subchannel != subchannels.end();
+            ++subchannel) {
+        // Configuring subchannel
+        PDEBUG("Subchannel:\n");
+        PDEBUG(" Start address: %zu\n",
+                (*subchannel)->startAddress());
+        PDEBUG(" Framesize: %zu\n",
+                (*subchannel)->framesize());
+        PDEBUG(" Bitrate: %zu\n", (*subchannel)->bitrate());
+        PDEBUG(" Framesize CU: %zu\n",
+                (*subchannel)->framesizeCu());
+        PDEBUG(" Protection: %zu\n",
+                (*subchannel)->protection());
+        PDEBUG("  Form: %zu\n",
+                (*subchannel)->protectionForm());
+        PDEBUG("  Level: %zu\n",
+                (*subchannel)->protectionLevel());
+        PDEBUG("  Option: %zu\n",
+                (*subchannel)->protectionOption());
+
+        // Energy dispersal, encoding, puncturing and time interleaving
+        // of all subchannels are done in the MSC encoder
+        myFlowgraph->connect(*subchannel, cifMux);
+    }
+
+    myFlowgraph->connect(cifMux, cifPart);
+}
+
+
+void DabModulator::setupOfdm(unsigned mode, ModPlugin* cifPart)
+{
+    // When the output rate is a rational multiple of the carrier
+    // spacing, the IFFT is zero-padded to run directly at the output
+    // rate and the Resampler is not needed. The FIR filter taps are
+    // designed for 2048000 samples/s, so keep interpolating after the
+    // filter if it is enabled, with half-band sections for power of
+    // two multiples and with the Resampler otherwise.
+    size_t ofdmSpacing = mySpacing;
+    size_t ofdmNullSize = myNullSize;
+    size_t ofdmSymSize = mySymSize;
+    float ofdmFactor = myFactor;
+    bool directRate = false;
+    bool halfBand = false;
+    if (myOutputRate != 2048000 && myFilterTapsFilename == "") {
+        directRate = scaleToOutputRate(
+                ofdmSpacing, ofdmNullSize, ofdmSymSize);
+    }
+    if (!directRate && myOutputRate % 2048000 == 0) {
+        halfBand = HalfBandInterpolator::isSupported(
+                myOutputRate / 2048000);
+    }
+    if ((directRate || halfBand) && myOutputRate > 2048000) {
+        // The Resampler does not preserve amplitude when
+        // interpolating, keep the same output level as before
+        ofdmFactor = myFactor * 2048000.0f / myOutputRate;
+    }
+
+    QpskSymbolMapper* cifMap = NULL;
+    FrequencyInterleaver* cifFreq = NULL;
+    PhaseReference* cifRef = NULL;
+    DifferentialModulator* cifDiff = NULL;
+    NullSymbol* cifNull = NULL;
+    SignalMultiplexer* cifSig = NULL;
+    CicEqualizer* cifCicEq = NULL;
+    OfdmGenerator* cifOfdm = NULL;
+    GainControl* cifGain = NULL;
+    GuardIntervalInserter* cifGuard = NULL;
+    FIRFilter* cifFilter = NULL;
+    ModCodec* cifRes = NULL;
+
+    cifMap = new QpskSymbolMapper(myNbCarriers);
+    cifRef = new PhaseReference(mode);
+    cifFreq = new FrequencyInterleaver(mode);
+    cifDiff = new DifferentialModulator(myNbCarriers);
+    cifNull = new NullSymbol(myNbCarriers);
+    cifSig = new SignalMultiplexer(
+            (1 + myNbSymbols) * myNbCarriers * sizeof(complexf));
+
+    if (myClockRate) {
+        unsigned ratio = myClockRate / myOutputRate;
+        ratio /= 4; // FPGA DUC
+        if (myClockRate == 400000000) { // USRP2
+            if (ratio & 1) { // odd
+                cifCicEq = new CicEqualizer(myNbCarriers,
+                        (float)mySpacing * (float)myOutputRate / 2048000.0f,
+                        ratio);
+            } // even, no filter
+        } else {
+            cifCicEq = new CicEqualizer(myNbCarriers,
+                    (float)mySpacing * (float)myOutputRate / 2048000.0f,
+                    ratio);
+        }
+    }
+
+    // The null symbol and the phase reference symbol do not change
+    cifOfdm = new OfdmGenerator((1 + myNbSymbols), myNbCarriers,
+            ofdmSpacing, true, 2);
+    cifGain = new GainControl(ofdmSpacing, myGainMode, ofdmFactor);
+    cifGuard = new GuardIntervalInserter(myNbSymbols, ofdmSpacing,
+            ofdmNullSize, ofdmSymSize);
+    if (myFilterTapsFilename != "") {
+        cifFilter = new FIRFilter(myFilterTapsFilename,
+                "firfilter" + myRcSuffix);
+        cifFilter->enrol_at(*myRC);
+    }
+
+    if (directRate) {
+        fprintf(stderr, "No resampler, OFDM synthesis with IFFT size "
+                "%zu\n", ofdmSpacing);
+    } else if (halfBand) {
+        fprintf(stderr, "Half-band interpolation by %u\n",
+                myOutputRate / 2048000);
+        cifRes = new HalfBandInterpolator(myOutputRate / 2048000);
+    } else if (myOutputRate != 2048000) {
+        cifRes = new Resampler(2048000, myOutputRate, mySpacing);
+    } else {
+        fprintf(stderr, "No resampler\n");
+    }
+
+    myFlowgraph->connect(cifPart, cifMap);
+    myFlowgraph->connect(cifMap, cifFreq);
+    myFlowgraph->connect(cifRef, cifDiff);
+    myFlowgraph->connect(cifFreq, cifDiff);
+    myFlowgraph->connect(cifNull, cifSig);
+    myFlowgraph->connect(cifDiff, cifSig);
+    if (myClockRate) {
+        myFlowgraph->connect(cifSig, cifCicEq);
+        myFlowgraph->connect(cifCicEq, cifOfdm);
+    } else {
+        myFlowgraph->connect(cifSig, cifOfdm);
+    }
+    myFlowgraph->connect(cifOfdm, cifGain);
+    myFlowgraph->connect(cifGain, cifGuard);
+
+    if (myFilterTapsFilename != "") {
+        myFlowgraph->connect(cifGuard, cifFilter);
+        if (cifRes != NULL) {
+            myFlowgraph->connect(cifFilter, cifRes);
+            myFlowgraph->connect(cifRes, myOutput);
+        } else {
+            myFlowgraph->connect(cifFilter, myOutput);
+        }
+    }
+    else { //no filtering
+        if (cifRes != NULL) {
+            myFlowgraph->connect(cifGuard, cifRes);
+            myFlowgraph->connect(cifRes, myOutput);
+        } else {
+            myFlowgraph->connect(cifGuard, myOutput);
+        }
+
+    }
+}
+
+
 int DabModulator::process(Buffer* const dataIn, Buffer* dataOut)
 {
     PDEBUG("DabModulator::process(dataIn: %p, dataOut: %p)\n",
             dataIn, dataOut);
 
-    myEtiReader.process(dataIn);
+    if (mySplitRole == SPLIT_HEAD) {
+        myEtiReader.processSplitFrame(dataIn, &myHeadFic, &myHeadCif);
+    } else {
+        myEtiReader.process(dataIn);
+    }
     if (myFlowgraph == NULL) {
         unsigned mode = myEtiReader.getMode();
         if (myDabMode != 0) {
@@ -150,220 +404,26 @@ int DabModulator::process(Buffer* const dataIn, Buffer* dataOut)
         setMode(mode);
 
         myFlowgraph = new Flowgraph();
-        ////////////////////////////////////////////////////////////////
-        // CIF data initialisation
-        ////////////////////////////////////////////////////////////////
-        FrameMultiplexer* cifMux = NULL;
-        PrbsGenerator* cifPrbs = NULL;
-        BlockPartitioner* cifPart = NULL;
-        QpskSymbolMapper* cifMap = NULL;
-        FrequencyInterleaver* cifFreq = NULL;
-        PhaseReference* cifRef = NULL;
-        DifferentialModulator* cifDiff = NULL;
-        NullSymbol* cifNull = NULL;
-        SignalMultiplexer* cifSig = NULL;
-        CicEqualizer* cifCicEq = NULL;
-        OfdmGenerator* cifOfdm = NULL;
-        GainControl* cifGain = NULL;
-        GuardIntervalInserter* cifGuard = NULL;
-        FIRFilter* cifFilter = NULL;
-        Resampler* cifRes = NULL;
-
-        cifPrbs = new PrbsGenerator(864 * 8, 0x110);
-        cifMux = new FrameMultiplexer(myFicSizeOut + 864 * 8,
-                &myEtiReader.getSubchannels());
-        cifPart = new BlockPartitioner(mode, myEtiReader.getFp());
-        cifMap = new QpskSymbolMapper(myNbCarriers);
-        cifRef = new PhaseReference(mode);
-        cifFreq = new FrequencyInterleaver(mode);
-        cifDiff = new DifferentialModulator(myNbCarriers);
-        cifNull = new NullSymbol(myNbCarriers);
-        cifSig = new SignalMultiplexer(
-                (1 + myNbSymbols) * myNbCarriers * sizeof(complexf));
-
-        if (myClockRate) {
-            unsigned ratio = myClockRate / myOutputRate;
-            ratio /= 4; // FPGA DUC
-            if (myClockRate == 400000000) { // USRP2
-                if (ratio & 1) { // odd
-                    cifCicEq = new CicEqualizer(myNbCarriers,
-                            (float)mySpacing * (float)myOutputRate / 2048000.0f,
-                            ratio);
-                } // even, no filter
-            } else {
-                cifCicEq = new CicEqualizer(myNbCarriers,
-                        (float)mySpacing * (float)myOutputRate / 2048000.0f,
-                        ratio);
-            }
-        }
-
-        cifOfdm = new OfdmGenerator((1 + myNbSymbols), myNbCarriers, mySpacing);
-        cifGain = new GainControl(mySpacing, myGainMode, myFactor);
-        cifGuard = new GuardIntervalInserter(myNbSymbols, mySpacing,
-                myNullSize, mySymSize);
-        if (myFilterTapsFilename != "") {
-            cifFilter = new FIRFilter(myFilterTapsFilename);
-            cifFilter->enrol_at(*myRC);
-        }
         myOutput = new OutputMemory();
-
-        if (myOutputRate != 2048000) {
-            cifRes = new Resampler(2048000, myOutputRate, mySpacing);
-        } else {
-            fprintf(stderr, "No resampler\n");
-        }
-
-        myFlowgraph->connect(cifPrbs, cifMux);
-
-        ////////////////////////////////////////////////////////////////
-        // Processing FIC
-        ////////////////////////////////////////////////////////////////
-        FicSource* fic = myEtiReader.getFic();
-        PrbsGenerator* ficPrbs = NULL;
-        ConvEncoder* ficConv = NULL;
-        PuncturingEncoder* ficPunc = NULL;
-        ////////////////////////////////////////////////////////////////
-        // Data initialisation
-        ////////////////////////////////////////////////////////////////
-        myFicSizeIn = fic->getFramesize();
-
-        ////////////////////////////////////////////////////////////////
-        // Modules configuration
-        ////////////////////////////////////////////////////////////////
-
-        // Configuring FIC channel
-
-        PDEBUG("FIC:\n");
-        PDEBUG(" Framesize: %zu\n", fic->getFramesize());
-
-        // Configuring prbs generator
-        ficPrbs = new PrbsGenerator(myFicSizeIn, 0x110);
-
-        // Configuring convolutionnal encoder
-        ficConv = new ConvEncoder(myFicSizeIn);
-
-        // Configuring puncturing encoder
-        ficPunc = new PuncturingEncoder();
-        std::vector<PuncturingRule*> rules = fic->get_rules();
-        std::vector<PuncturingRule*>::const_iterator rule;
-        for (rule = rules.begin(); rule != rules.end(); ++rule) {
-            PDEBUG(" Adding rule:\n");
-            PDEBUG("  Length: %zu\n", (*rule)->length());
-            PDEBUG("  Pattern: 0x%x\n", (*rule)->pattern());
-            ficPunc->append_rule(*(*rule));
-        }
-        PDEBUG(" Adding tail\n");
-        ficPunc->append_tail_rule(PuncturingRule(3, 0xcccccc));
-
-        myFlowgraph->connect(fic, ficPrbs);
-        myFlowgraph->connect(ficPrbs, ficConv);
-        myFlowgraph->connect(ficConv, ficPunc);
-        myFlowgraph->connect(ficPunc, cifPart);
-
-        ////////////////////////////////////////////////////////////////
-        // Configuring subchannels
-        ////////////////////////////////////////////////////////////////
-        std::vector<SubchannelSource*> subchannels =
-            myEtiReader.getSubchannels();
-        std::vector<SubchannelSource*>::const_iterator subchannel;
-        for (subchannel = subchannels.begin();
-                subchannel != subchannels.end();
-                ++subchannel) {
-            PrbsGenerator* subchPrbs = NULL;
-            ConvEncoder* subchConv = NULL;
-            PuncturingEncoder* subchPunc = NULL;
-            TimeInterleaver* subchInterleaver = NULL;
-
-            ////////////////////////////////////////////////////////////
-            // Data initialisation
-            ////////////////////////////////////////////////////////////
-            size_t subchSizeIn = (*subchannel)->framesize();
-            size_t subchSizeOut = (*subchannel)->framesizeCu() * 8;
-
-            ////////////////////////////////////////////////////////////
-            // Modules configuration
-            ////////////////////////////////////////////////////////////
-
-            // Configuring subchannel
-            PDEBUG("Subchannel:\n");
-            PDEBUG(" Start address: %zu\n",
-                    (*subchannel)->startAddress());
-            PDEBUG(" Framesize: %zu\n",
-                    (*subchannel)->framesize());
-            PDEBUG(" Bitrate: %zu\n", (*subchannel)->bitrate());
-            PDEBUG(" Framesize CU: %zu\n",
-                    (*subchannel)->framesizeCu());
-            PDEBUG(" Protection: %zu\n",
-                    (*subchannel)->protection());
-            PDEBUG("  Form: %zu\n",
-                    (*subchannel)->protectionForm());
-            PDEBUG("  Level: %zu\n",
-                    (*subchannel)->protectionLevel());
-            PDEBUG("  Option: %zu\n",
-                    (*subchannel)->protectionOption());
-
-            // Configuring prbs genrerator
-            subchPrbs = new PrbsGenerator(subchSizeIn, 0x110);
-
-            // Configuring convolutionnal encoder
-            subchConv = new ConvEncoder(subchSizeIn);
-
-            // Configuring puncturing encoder
-            subchPunc = new PuncturingEncoder();
-            std::vector<PuncturingRule*> rules = (*subchannel)->get_rules();
-            std::vector<PuncturingRule*>::const_iterator rule;
-            for (rule = rules.begin(); rule != rules.end(); ++rule) {
-                PDEBUG(" Adding rule:\n");
-                PDEBUG("  Length: %zu\n", (*rule)->length());
-                PDEBUG("  Pattern: 0x%x\n", (*rule)->pattern());
-                subchPunc->append_rule(*(*rule));
-            }
-            PDEBUG(" Adding tail\n");
-            subchPunc->append_tail_rule(PuncturingRule(3, 0xcccccc));
-
-            // Configuring time interleaver
-            subchInterleaver = new TimeInterleaver(subchSizeOut);
-
-            myFlowgraph->connect(*subchannel, subchPrbs);
-            myFlowgraph->connect(subchPrbs, subchConv);
-            myFlowgraph->connect(subchConv, subchPunc);
-            myFlowgraph->connect(subchPunc, subchInterleaver);
-            myFlowgraph->connect(subchInterleaver, cifMux);
+        if (myRC) {
+            myEtiReader.enrol_at(*myRC);
         }
 
-        myFlowgraph->connect(cifMux, cifPart);
-        myFlowgraph->connect(cifPart, cifMap);
-        myFlowgraph->connect(cifMap, cifFreq);
-        myFlowgraph->connect(cifRef, cifDiff);
-        myFlowgraph->connect(cifFreq, cifDiff);
-        myFlowgraph->connect(cifNull, cifSig);
-        myFlowgraph->connect(cifDiff, cifSig);
-        if (myClockRate) {
-            myFlowgraph->connect(cifSig, cifCicEq);
-            myFlowgraph->connect(cifCicEq, cifOfdm);
+        if (mySplitRole == SPLIT_CENTRAL) {
+            // The OFDM heads do the rest
+            SplitFrameEncoder* splitEnc = new SplitFrameEncoder(&myEtiReader);
+            setupCoding(splitEnc);
+            myFlowgraph->connect(splitEnc, myOutput);
         } else {
-            myFlowgraph->connect(cifSig, cifOfdm);
-        }
-        myFlowgraph->connect(cifOfdm, cifGain);
-        myFlowgraph->connect(cifGain, cifGuard);
-
-        if (myFilterTapsFilename != "") {
-            myFlowgraph->connect(cifGuard, cifFilter);
-            if (cifRes != NULL) {
-                myFlowgraph->connect(cifFilter, cifRes);
-                myFlowgraph->connect(cifRes, myOutput);
+            BlockPartitioner* cifPart = new BlockPartitioner(mode,
+                    myEtiReader.getFp());
+            if (mySplitRole == SPLIT_HEAD) {
+                myFlowgraph->connect(new InputMemory(&myHeadFic), cifPart);
+                myFlowgraph->connect(new InputMemory(&myHeadCif), cifPart);
             } else {
-                myFlowgraph->connect(cifFilter, myOutput);
+                setupCoding(cifPart);
             }
-        }
-        else { //no filtering
-            if (cifRes != NULL) {
-                myFlowgraph->connect(cifGuard, cifRes);
-                myFlowgraph->connect(cifRes, myOutput);
-            } else {
-                myFlowgraph->connect(cifGuard, myOutput);
-            }
-
+            setupOfdm(mode, cifPart);
         }
     }
 
@@ -371,5 +431,12 @@ int DabModulator::process(Buffer* const dataIn, Buffer* dataOut)
     // Proccessing data
     ////////////////////////////////////////////////////////////////////
     myOutput->setOutput(dataOut);
-    return myFlowgraph->run();
+    int ret = myFlowgraph->run();
+
+    // The output of a central instance is the coded frame, which the
+    // heads need whole. They mute it according to the split frame flags.
+    if (myEtiReader.isMuted() && mySplitRole != SPLIT_CENTRAL) {
+        memset(dataOut->getData(), 0, dataOut->getLength());
+    }
+    return ret;
 }
@@ -35,6 +35,7 @@
 
 #include "ModCodec.h"
 #include "EtiReader.h"
+#include "SplitFrame.h"
 #include "Flowgraph.h"
 #include "GainControl.h"
 #include "OutputMemory.h"
@@ -51,7 +52,8 @@ public:
             Logger& logger,
             unsigned outputRate = 2048000, unsigned clockRate = 0,
             unsigned dabMode = 0, GainMode gainMode = GAIN_VAR,
-            float factor = 1.0, std::string filterTapsFilename = "");
+            float factor = 1.0, std::string filterTapsFilename = "",
+            SplitRole splitRole = SPLIT_NONE, std::string rcSuffix = "");
     DabModulator(const DabModulator& copy);
     virtual ~DabModulator();
 
@@ -66,6 +68,20 @@ protected:
 
     void setMode(unsigned mode);
 
+    /* Scale the OFDM spacing, null and symbol sizes to the output rate.
+     * Returns false if the sizes are not integer at that rate, or if the
+     * resulting IFFT would be too slow, in which case the Resampler must
+     * be used. */
+    bool scaleToOutputRate(size_t& spacing, size_t& nullSize,
+            size_t& symSize);
+
+    /* Energy dispersal and channel coding of the FIC and the MSC, whose
+     * outputs are connected to cifPart */
+    void setupCoding(ModPlugin* cifPart);
+
+    /* QPSK mapping up to the output, from the CIFs of cifPart */
+    void setupOfdm(unsigned mode, ModPlugin* cifPart);
+
     unsigned myOutputRate;
     unsigned myClockRate;
     unsigned myDabMode;
@@ -77,6 +93,14 @@ protected:
     std::string myFilterTapsFilename;
     BaseRemoteController* myRC;
 
+    // Coded FIC and CIF received by an OFDM head
+    SplitRole mySplitRole;
+    Buffer myHeadFic;
+    Buffer myHeadCif;
+
+    // Appended to the names of the remote controllable blocks
+    std::string myRcSuffix;
+
     size_t myNbSymbols;
     size_t myNbCarriers;
     size_t mySpacing;
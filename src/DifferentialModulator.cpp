@@ -26,6 +26,9 @@
 #include <stdexcept>
 #include <complex>
 #include <string.h>
+#ifdef __SSE__
+#   include <xmmintrin.h>
+#endif
 
 typedef std::complex<float> complexf;
 
@@ -36,6 +39,24 @@ DifferentialModulator::DifferentialModulator(size_t carriers) :
 {
     PDEBUG("DifferentialModulator::DifferentialModulator(%zu)\n", carriers);
 
+    switch (carriers) {
+    case 1536:
+        d_modulateSymbol = modulateSymbol<1536>;
+        break;
+    case 384:
+        d_modulateSymbol = modulateSymbol<384>;
+        break;
+    case 192:
+        d_modulateSymbol = modulateSymbol<192>;
+        break;
+    case 768:
+        d_modulateSymbol = modulateSymbol<768>;
+        break;
+    default:
+        throw std::runtime_error("DifferentialModulator::DifferentialModulator "
+                "nb of carriers invalid!");
+    }
+
 }
 
 
@@ -46,6 +67,34 @@ DifferentialModulator::~DifferentialModulator()
 }
 
 
+template<size_t carriers>
+void DifferentialModulator::modulateSymbol(const complexf* prev,
+        const complexf* in, complexf* out)
+{
+#ifdef __SSE__
+    // Symbols start on 32 bytes boundaries, two carriers per register
+    const __m128* a = reinterpret_cast<const __m128*>(prev);
+    const __m128* b = reinterpret_cast<const __m128*>(in);
+    __m128* c = reinterpret_cast<__m128*>(out);
+    const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    for (size_t j = 0; j < carriers / 2; ++j) {
+        __m128 re = _mm_shuffle_ps(b[j], b[j], _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 im = _mm_shuffle_ps(b[j], b[j], _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 swap = _mm_shuffle_ps(a[j], a[j], _MM_SHUFFLE(2, 3, 0, 1));
+        c[j] = _mm_add_ps(_mm_mul_ps(a[j], re),
+                _mm_xor_ps(_mm_mul_ps(swap, im), sign));
+    }
+#else
+    for (size_t j = 0; j < carriers; j += 4) {
+        out[j] = prev[j] * in[j];
+        out[j + 1] = prev[j + 1] * in[j + 1];
+        out[j + 2] = prev[j + 2] * in[j + 2];
+        out[j + 3] = prev[j + 3] * in[j + 3];
+    }
+#endif
+}
+
+
 // dataIn[0] -> phase reference
 // dataIn[1] -> data symbols
 int DifferentialModulator::process(std::vector<Buffer*> dataIn, Buffer* dataOut)
@@ -86,12 +135,7 @@ int DifferentialModulator::process(std::vector<Buffer*> dataIn, Buffer* dataOut)
 
     memcpy(dataOut->getData(), phase, phaseSize * sizeof(complexf));
     for (size_t i = 0; i < dataSize; i += d_carriers) {
-        for (size_t j = 0; j < d_carriers; j += 4) {
-            out[d_carriers + j] = out[j] * in[j];
-            out[d_carriers + j + 1] = out[j + 1] * in[j + 1];
-            out[d_carriers + j + 2] = out[j + 2] * in[j + 2];
-            out[d_carriers + j + 3] = out[j + 3] * in[j + 3];
-        }
+        d_modulateSymbol(out, in, out + d_carriers);
         in += d_carriers;
         out += d_carriers;
     }
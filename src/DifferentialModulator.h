@@ -30,6 +30,7 @@
 #include "ModMux.h"
 
 #include <sys/types.h>
+#include <complex>
 
 
 class DifferentialModulator : public ModMux
@@ -46,6 +47,14 @@ public:
 
 protected:
     size_t d_carriers;
+
+    // Modulates one OFDM symbol against the previous one, instantiated
+    // for the carriers of each mode
+    void (*d_modulateSymbol)(const std::complex<float>* prev,
+            const std::complex<float>* in, std::complex<float>* out);
+    template<size_t carriers>
+    static void modulateSymbol(const std::complex<float>* prev,
+            const std::complex<float>* in, std::complex<float>* out);
 };
 
 
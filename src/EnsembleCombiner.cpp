@@ -0,0 +1,213 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EnsembleCombiner.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdexcept>
+#ifdef __SSE__
+#   include <xmmintrin.h>
+#endif
+
+
+EnsembleCombiner::EnsembleCombiner() :
+    ModMux(ModFormat(0), ModFormat(0)),
+    myRunning(false)
+{
+    PDEBUG("EnsembleCombiner::EnsembleCombiner() @ %p\n", this);
+}
+
+
+EnsembleCombiner::~EnsembleCombiner()
+{
+    PDEBUG("EnsembleCombiner::~EnsembleCombiner() @ %p\n", this);
+
+    stopWorkers();
+
+    std::vector<CombinerEnsemble*>::iterator ensemble;
+    for (ensemble = myEnsembles.begin(); ensemble != myEnsembles.end();
+            ++ensemble) {
+        delete (*ensemble)->modulator;
+        delete (*ensemble)->shifter;
+        delete *ensemble;
+    }
+}
+
+
+void EnsembleCombiner::addEnsemble(DabModulator* modulator,
+        FrequencyShifter* shifter)
+{
+    if (myRunning) {
+        throw std::runtime_error(
+                "EnsembleCombiner::addEnsemble cannot add ensembles "
+                "after the first frame!");
+    }
+
+    CombinerEnsemble* ensemble = new CombinerEnsemble();
+    ensemble->modulator = modulator;
+    ensemble->shifter = shifter;
+    ensemble->ready = false;
+    ensemble->input = NULL;
+    myEnsembles.push_back(ensemble);
+}
+
+
+void EnsembleCombiner::modulate(CombinerEnsemble* ensemble)
+{
+    try {
+        if (ensemble->modulator->process(ensemble->input,
+                    &ensemble->modulated)) {
+            if (ensemble->ready) {
+                // Happens when the ensembles do not have the same frame
+                // duration, the previous frame was never combined.
+                fprintf(stderr, "EnsembleCombiner: ensembles not aligned, "
+                        "dropping a frame\n");
+            }
+            ensemble->shifter->process(&ensemble->modulated,
+                    &ensemble->shifted);
+            ensemble->ready = true;
+        }
+    }
+    catch (std::exception& e) {
+        ensemble->error = e.what();
+    }
+}
+
+
+void EnsembleCombiner::workerProcess(CombinerEnsemble* ensemble)
+{
+    try {
+        while (myRunning) {
+            myStartBarrier->wait();
+            modulate(ensemble);
+            myDoneBarrier->wait();
+        }
+    }
+    catch (boost::thread_interrupted&) {
+    }
+}
+
+
+void EnsembleCombiner::startWorkers()
+{
+    myRunning = true;
+    myStartBarrier.reset(new boost::barrier(myEnsembles.size()));
+    myDoneBarrier.reset(new boost::barrier(myEnsembles.size()));
+
+    // The caller modulates the first ensemble itself
+    for (size_t i = 1; i < myEnsembles.size(); ++i) {
+        myWorkers.push_back(new boost::thread(
+                    &EnsembleCombiner::workerProcess, this, myEnsembles[i]));
+    }
+}
+
+
+void EnsembleCombiner::stopWorkers()
+{
+    myRunning = false;
+
+    std::vector<boost::thread*>::iterator worker;
+    for (worker = myWorkers.begin(); worker != myWorkers.end(); ++worker) {
+        (*worker)->interrupt();
+        (*worker)->join();
+        delete *worker;
+    }
+    myWorkers.clear();
+}
+
+
+int EnsembleCombiner::process(std::vector<Buffer*> dataIn, Buffer* dataOut)
+{
+    PDEBUG("EnsembleCombiner::process(dataIn: %zu, dataOut: %p)\n",
+            dataIn.size(), dataOut);
+
+    if (dataIn.size() != myEnsembles.size() || myEnsembles.empty()) {
+        throw std::runtime_error(
+                "EnsembleCombiner::process nb of input streams does not "
+                "match the nb of ensembles!");
+    }
+
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        myEnsembles[i]->input = dataIn[i];
+    }
+
+    if (!myRunning) {
+        for (size_t i = 0; i < myEnsembles.size(); ++i) {
+            modulate(myEnsembles[i]);
+        }
+        startWorkers();
+    }
+    else {
+        myStartBarrier->wait();
+        modulate(myEnsembles[0]);
+        myDoneBarrier->wait();
+    }
+
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        if (!myEnsembles[i]->error.empty()) {
+            std::string error = myEnsembles[i]->error;
+            myEnsembles[i]->error.clear();
+            throw std::runtime_error("EnsembleCombiner: " + error);
+        }
+    }
+
+    // Wait until every ensemble has a frame to contribute
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        if (!myEnsembles[i]->ready) {
+            return 0;
+        }
+    }
+
+    size_t length = myEnsembles[0]->shifted.getLength();
+    for (size_t i = 1; i < myEnsembles.size(); ++i) {
+        if (myEnsembles[i]->shifted.getLength() != length) {
+            throw std::runtime_error(
+                    "EnsembleCombiner::process ensembles have different "
+                    "frame lengths, use the same transmission mode!");
+        }
+    }
+
+    dataOut->setLength(length);
+    float* out = reinterpret_cast<float*>(dataOut->getData());
+    size_t sizeOut = length / sizeof(float);
+
+    memcpy(out, myEnsembles[0]->shifted.getData(), length);
+    myEnsembles[0]->ready = false;
+    for (size_t i = 1; i < myEnsembles.size(); ++i) {
+        const float* in =
+            reinterpret_cast<const float*>(myEnsembles[i]->shifted.getData());
+        size_t j = 0;
+#ifdef __SSE__
+        for (; j + 4 <= sizeOut; j += 4) {
+            _mm_storeu_ps(&out[j],
+                    _mm_add_ps(_mm_loadu_ps(&out[j]), _mm_loadu_ps(&in[j])));
+        }
+#endif
+        for (; j < sizeOut; ++j) {
+            out[j] += in[j];
+        }
+        myEnsembles[i]->ready = false;
+    }
+
+    return dataOut->getLength();
+}
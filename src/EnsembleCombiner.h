@@ -0,0 +1,98 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENSEMBLE_COMBINER_H
+#define ENSEMBLE_COMBINER_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModMux.h"
+#include "DabModulator.h"
+#include "FrequencyShifter.h"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+
+struct CombinerEnsemble {
+    DabModulator* modulator;
+    FrequencyShifter* shifter;
+    Buffer modulated;
+    // Shifted frame, waiting to be combined when ready is set
+    Buffer shifted;
+    bool ready;
+    // ETI frame of the current call
+    Buffer* input;
+    // Set by the worker thread when modulation failed
+    std::string error;
+};
+
+
+/* Modulates several ensembles, one per input, shifts each of them to its
+ * frequency offset and sums them into one wideband signal.
+ *
+ * The first frame is modulated sequentially, so that the modulators build
+ * their flowgraphs and shared tables one after the other. From the second
+ * frame on, ensembles 1 to N-1 are modulated by worker threads while the
+ * caller modulates ensemble 0.
+ */
+class EnsembleCombiner : public ModMux
+{
+public:
+    EnsembleCombiner();
+    virtual ~EnsembleCombiner();
+    EnsembleCombiner(const EnsembleCombiner&);
+    EnsembleCombiner& operator=(const EnsembleCombiner&);
+
+    // Takes ownership of modulator and shifter. The ensembles are
+    // connected as inputs in the same order.
+    void addEnsemble(DabModulator* modulator, FrequencyShifter* shifter);
+
+    int process(std::vector<Buffer*> dataIn, Buffer* dataOut);
+    const char* name() { return "EnsembleCombiner"; }
+
+    /* Required to get the timestamp */
+    EtiReader* getEtiReader() {
+        return myEnsembles[0]->modulator->getEtiReader();
+    }
+
+protected:
+    void modulate(CombinerEnsemble* ensemble);
+    void workerProcess(CombinerEnsemble* ensemble);
+    void startWorkers();
+    void stopWorkers();
+
+    std::vector<CombinerEnsemble*> myEnsembles;
+
+    bool myRunning;
+    std::vector<boost::thread*> myWorkers;
+    boost::shared_ptr<boost::barrier> myStartBarrier;
+    boost::shared_ptr<boost::barrier> myDoneBarrier;
+};
+
+
+#endif // ENSEMBLE_COMBINER_H
@@ -0,0 +1,305 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EnsembleHost.h"
+#include "Flowgraph.h"
+#include "InputMemory.h"
+#include "InputReader.h"
+#include "OutputFile.h"
+#include "Numa.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdexcept>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+
+
+EnsembleHost::EnsembleHost(struct modulator_offset_config& modconf,
+        BaseRemoteController* rc, Logger& logger,
+        unsigned outputRate, unsigned clockRate, unsigned dabMode,
+        GainMode gainMode, float factor, std::string filterTapsFilename,
+        bool loop) :
+    RemoteControllable("supervisor"),
+    myModconf(modconf),
+    myRC(rc),
+    myLogger(logger),
+    myOutputRate(outputRate),
+    myClockRate(clockRate),
+    myDabMode(dabMode),
+    myGainMode(gainMode),
+    myFactor(factor),
+    myFilterTapsFilename(filterTapsFilename),
+    myLoop(loop),
+    myCrcPolicy(ETI_CRC_LOG),
+    myRunning(false)
+{
+    PDEBUG("EnsembleHost::EnsembleHost() @ %p\n", this);
+
+    RC_ADD_PARAMETER(frames, "(Read-only) frames modulated by each ensemble.");
+    RC_ADD_PARAMETER(running, "(Read-only) number of ensembles running.");
+}
+
+
+EnsembleHost::~EnsembleHost()
+{
+    PDEBUG("EnsembleHost::~EnsembleHost() @ %p\n", this);
+
+    stop();
+
+    std::vector<HostedEnsemble*>::iterator ensemble;
+    for (ensemble = myEnsembles.begin(); ensemble != myEnsembles.end();
+            ++ensemble) {
+        delete *ensemble;
+    }
+}
+
+
+void EnsembleHost::addEnsemble(const std::string& source,
+        const std::string& outputName, const std::vector<int>& cpus,
+        int numaNode)
+{
+    HostedEnsemble* ensemble = new HostedEnsemble();
+    ensemble->source = source;
+    ensemble->outputName = outputName;
+    ensemble->cpus = cpus;
+    ensemble->numaNode = numaNode;
+    ensemble->thread = NULL;
+    ensemble->frames = 0;
+    ensemble->running = false;
+    myEnsembles.push_back(ensemble);
+}
+
+
+void EnsembleHost::start()
+{
+    PDEBUG("EnsembleHost::start() @ %p\n", this);
+
+    {
+        boost::mutex::scoped_lock lock(myMutex);
+        myRunning = true;
+        for (size_t i = 0; i < myEnsembles.size(); ++i) {
+            myEnsembles[i]->running = true;
+        }
+    }
+
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        myEnsembles[i]->thread = new boost::thread(
+                &EnsembleHost::hostProcess, this, myEnsembles[i], i);
+    }
+}
+
+
+void EnsembleHost::stop()
+{
+    PDEBUG("EnsembleHost::stop() @ %p\n", this);
+
+    {
+        boost::mutex::scoped_lock lock(myMutex);
+        myRunning = false;
+    }
+
+    std::vector<HostedEnsemble*>::iterator ensemble;
+    for (ensemble = myEnsembles.begin(); ensemble != myEnsembles.end();
+            ++ensemble) {
+        if ((*ensemble)->thread != NULL) {
+            (*ensemble)->thread->join();
+            delete (*ensemble)->thread;
+            (*ensemble)->thread = NULL;
+        }
+    }
+}
+
+
+size_t EnsembleHost::running()
+{
+    boost::mutex::scoped_lock lock(myMutex);
+    size_t count = 0;
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        if (myEnsembles[i]->running) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+unsigned long EnsembleHost::frames()
+{
+    boost::mutex::scoped_lock lock(myMutex);
+    unsigned long frames = 0;
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        frames += myEnsembles[i]->frames;
+    }
+    return frames;
+}
+
+
+void EnsembleHost::printStats()
+{
+    boost::mutex::scoped_lock lock(myMutex);
+    for (size_t i = 0; i < myEnsembles.size(); ++i) {
+        const HostedEnsemble* ensemble = myEnsembles[i];
+        fprintf(stderr, "  ensemble%zu: %lu frames, %s%s\n", i + 1,
+                ensemble->frames,
+                ensemble->running ? "running" :
+                ensemble->error.empty() ? "stopped" : "failed: ",
+                ensemble->error.c_str());
+    }
+}
+
+
+void EnsembleHost::pinThread(HostedEnsemble* ensemble, size_t index)
+{
+    if (ensemble->numaNode >= 0 && !numaBindThread(ensemble->numaNode)) {
+        fprintf(stderr, "Warning: unable to place ensemble%zu on NUMA node "
+                "%d\n", index + 1, ensemble->numaNode);
+    }
+
+    // The CPUs, when given, further restrict the ones of the node
+    if (ensemble->cpus.empty()) {
+        return;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (size_t i = 0; i < ensemble->cpus.size(); ++i) {
+        CPU_SET(ensemble->cpus[i], &cpuset);
+    }
+
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset),
+            &cpuset);
+    if (ret != 0) {
+        fprintf(stderr, "Warning: unable to pin ensemble%zu to its CPUs: "
+                "%s\n", index + 1, strerror(ret));
+    }
+}
+
+
+void EnsembleHost::modulate(HostedEnsemble* ensemble, size_t index)
+{
+    // Threads inherit the affinity, pinning before the modulator builds
+    // its flowgraph also pins the threads of its blocks
+    pinThread(ensemble, index);
+
+    InputFileReader reader(myLogger);
+    if (reader.Open(ensemble->source, myLoop) == -1) {
+        throw std::runtime_error("unable to open input file " +
+                ensemble->source);
+    }
+
+    std::stringstream rcSuffix;
+    rcSuffix << (index + 1);
+
+    Buffer data;
+    data.setLength(6144);
+
+    Flowgraph flowgraph;
+    OutputFile* output = new OutputFile(ensemble->outputName);
+    DabModulator* modulator = new DabModulator(myModconf, myRC, myLogger,
+            myOutputRate, myClockRate, myDabMode, myGainMode, myFactor,
+            myFilterTapsFilename, SPLIT_NONE, rcSuffix.str());
+    modulator->getEtiReader()->setCrcPolicy(myCrcPolicy);
+    flowgraph.connect(new InputMemory(&data), modulator);
+    flowgraph.connect(modulator, output);
+
+    int framesize;
+    while ((framesize = reader.GetNextFrame(data.getData())) > 0) {
+        if (ensemble->frames == 0) {
+            // The modulators build their flowgraphs and enrol at the
+            // remote control on their first frame, one at a time
+            boost::mutex::scoped_lock lock(mySetupMutex);
+            flowgraph.run();
+        }
+        else {
+            flowgraph.run();
+        }
+
+        boost::mutex::scoped_lock lock(myMutex);
+        ++ensemble->frames;
+        if (!myRunning) {
+            break;
+        }
+    }
+    if (framesize < 0) {
+        throw std::runtime_error("input read error");
+    }
+}
+
+
+void EnsembleHost::hostProcess(HostedEnsemble* ensemble, size_t index)
+{
+    std::string error;
+    try {
+        modulate(ensemble, index);
+    }
+    catch (std::exception& e) {
+        error = e.what();
+        fprintf(stderr, "Error: ensemble%zu: %s\n", index + 1, e.what());
+    }
+
+    boost::mutex::scoped_lock lock(myMutex);
+    ensemble->running = false;
+    ensemble->error = error;
+}
+
+
+void EnsembleHost::set_parameter(const string& parameter,
+        const string& value)
+{
+    if (parameter == "frames" || parameter == "running") {
+        throw ParameterError("Parameter '" + parameter + "' is read-only");
+    }
+    else {
+        stringstream ss;
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+}
+
+
+const string EnsembleHost::get_parameter(const string& parameter) const
+{
+    stringstream ss;
+    boost::mutex::scoped_lock lock(myMutex);
+    if (parameter == "frames") {
+        for (size_t i = 0; i < myEnsembles.size(); ++i) {
+            ss << (i ? " " : "") << myEnsembles[i]->frames;
+        }
+    }
+    else if (parameter == "running") {
+        size_t count = 0;
+        for (size_t i = 0; i < myEnsembles.size(); ++i) {
+            if (myEnsembles[i]->running) {
+                ++count;
+            }
+        }
+        ss << count;
+    }
+    else {
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+    return ss.str();
+}
@@ -0,0 +1,119 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENSEMBLE_HOST_H
+#define ENSEMBLE_HOST_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "DabModulator.h"
+#include "RemoteControl.h"
+#include "Log.h"
+
+#include <boost/thread.hpp>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+
+struct HostedEnsemble {
+    std::string source;
+    std::string outputName;
+    // CPUs the thread of this ensemble is pinned to, all if empty
+    std::vector<int> cpus;
+    // NUMA node of the thread and its buffers, none if negative
+    int numaNode;
+    boost::thread* thread;
+    // Written by the thread of the ensemble, protected by the host mutex
+    unsigned long frames;
+    bool running;
+    std::string error;
+};
+
+
+/* Hosts several independent ensembles in one process, each one with its
+ * own input, modulator and output file, running in its own thread pinned
+ * to its own CPUs or NUMA node. The modulators share the read-only tables (FFT plans,
+ * interleaver permutation, phase reference, energy dispersal and
+ * convolutional encoder tables) and the remote control, where their
+ * blocks are suffixed with the number of the ensemble, e.g. firfilter2.
+ * The host itself exports the frame counters of all ensembles.
+ */
+class EnsembleHost : public RemoteControllable
+{
+public:
+    EnsembleHost(struct modulator_offset_config& modconf,
+            BaseRemoteController* rc, Logger& logger,
+            unsigned outputRate, unsigned clockRate, unsigned dabMode,
+            GainMode gainMode, float factor, std::string filterTapsFilename,
+            bool loop);
+    virtual ~EnsembleHost();
+    EnsembleHost(const EnsembleHost&);
+    EnsembleHost& operator=(const EnsembleHost&);
+
+    void addEnsemble(const std::string& source,
+            const std::string& outputName, const std::vector<int>& cpus,
+            int numaNode = -1);
+
+    // Applies to the ensembles started afterwards
+    void setCrcPolicy(EtiCrcPolicy policy) { myCrcPolicy = policy; }
+
+    void start();
+    void stop();
+
+    // Number of ensembles that are still being modulated
+    size_t running();
+    // Sum of the frames of all ensembles
+    unsigned long frames();
+    void printStats();
+
+    /******* REMOTE CONTROL ********/
+    virtual void set_parameter(const string& parameter, const string& value);
+    virtual const string get_parameter(const string& parameter) const;
+
+protected:
+    void hostProcess(HostedEnsemble* ensemble, size_t index);
+    void modulate(HostedEnsemble* ensemble, size_t index);
+    void pinThread(HostedEnsemble* ensemble, size_t index);
+
+    struct modulator_offset_config& myModconf;
+    BaseRemoteController* myRC;
+    Logger& myLogger;
+    unsigned myOutputRate;
+    unsigned myClockRate;
+    unsigned myDabMode;
+    GainMode myGainMode;
+    float myFactor;
+    std::string myFilterTapsFilename;
+    bool myLoop;
+    EtiCrcPolicy myCrcPolicy;
+
+    std::vector<HostedEnsemble*> myEnsembles;
+    bool myRunning;
+    mutable boost::mutex myMutex;
+    boost::mutex mySetupMutex;
+};
+
+
+#endif // ENSEMBLE_HOST_H
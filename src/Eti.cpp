@@ -27,6 +27,40 @@
 #   include "Eti.h"
 #endif
 
+#include <string.h>
+#include <boost/thread/once.hpp>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+
+// Both sync words, as they appear in the stream
+static const uint8_t SYNC_ODD[4] = { 0xff, 0xf8, 0xc5, 0x49 };
+static const uint8_t SYNC_EVEN[4] = { 0xff, 0x07, 0x3a, 0xb6 };
+
+// CRC of each byte value followed by 0 to 7 zero bytes, to process eight
+// bytes per step
+static uint16_t CRC16_TABLE[8][256];
+static boost::once_flag crc16TableOnce = BOOST_ONCE_INIT;
+
+
+static void fillCrc16Table()
+{
+    for (unsigned n = 0; n < 256; ++n) {
+        uint16_t crc = n << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+        CRC16_TABLE[0][n] = crc;
+    }
+    for (unsigned n = 0; n < 256; ++n) {
+        for (int k = 1; k < 8; ++k) {
+            uint16_t crc = CRC16_TABLE[k - 1][n];
+            CRC16_TABLE[k][n] = (crc << 8) ^ CRC16_TABLE[0][crc >> 8];
+        }
+    }
+}
+
 
 //definitions des structures des champs du ETI(NI, G703)
 
@@ -68,3 +102,99 @@ uint16_t eti_STC::getStartAddress()
 {
     return (uint16_t)((startAddress_high << 8) + startAddress_low);
 }
+
+
+size_t findEtiSync(const uint8_t* data, size_t length)
+{
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // Compares 16 positions at a time, each of the four bytes of the sync
+    // word comes from its own unaligned load
+    const __m128i odd0 = _mm_set1_epi8((char)SYNC_ODD[0]);
+    const __m128i odd1 = _mm_set1_epi8((char)SYNC_ODD[1]);
+    const __m128i odd2 = _mm_set1_epi8((char)SYNC_ODD[2]);
+    const __m128i odd3 = _mm_set1_epi8((char)SYNC_ODD[3]);
+    const __m128i even1 = _mm_set1_epi8((char)SYNC_EVEN[1]);
+    const __m128i even2 = _mm_set1_epi8((char)SYNC_EVEN[2]);
+    const __m128i even3 = _mm_set1_epi8((char)SYNC_EVEN[3]);
+
+    for (; i + 16 + 3 <= length; i += 16) {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(data + i + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(data + i + 2));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(data + i + 3));
+
+        __m128i odd = _mm_and_si128(
+                _mm_and_si128(_mm_cmpeq_epi8(b1, odd1),
+                    _mm_cmpeq_epi8(b2, odd2)),
+                _mm_cmpeq_epi8(b3, odd3));
+        __m128i even = _mm_and_si128(
+                _mm_and_si128(_mm_cmpeq_epi8(b1, even1),
+                    _mm_cmpeq_epi8(b2, even2)),
+                _mm_cmpeq_epi8(b3, even3));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, odd0),
+                    _mm_or_si128(odd, even)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; i + 4 <= length; ++i) {
+        if (memcmp(data + i, SYNC_ODD, 4) == 0 ||
+                memcmp(data + i, SYNC_EVEN, 4) == 0) {
+            return i;
+        }
+    }
+    return length;
+}
+
+
+uint16_t etiCrc16(const uint8_t* data, size_t length)
+{
+    // Modulators can be created from several threads at the same time
+    boost::call_once(crc16TableOnce, fillCrc16Table);
+    const uint16_t (*table)[256] = CRC16_TABLE;
+
+    uint16_t crc = 0xffff;
+    for (; length >= 8; length -= 8, data += 8) {
+        crc = table[7][data[0] ^ (crc >> 8)] ^
+            table[6][data[1] ^ (crc & 0xff)] ^
+            table[5][data[2]] ^ table[4][data[3]] ^
+            table[3][data[4]] ^ table[2][data[5]] ^
+            table[1][data[6]] ^ table[0][data[7]];
+    }
+    for (; length > 0; --length, ++data) {
+        crc = (crc << 8) ^ table[0][(crc >> 8) ^ *data];
+    }
+    return crc ^ 0xffff;
+}
+
+
+bool isEtiFrameStart(const uint8_t* frame, size_t length)
+{
+    if (length < 8 || (memcmp(frame, SYNC_ODD, 4) != 0 &&
+                memcmp(frame, SYNC_EVEN, 4) != 0)) {
+        return false;
+    }
+
+    eti_FC fc;
+    memcpy(&fc, frame + 4, sizeof(fc));
+    if (8 + 4 * (size_t)fc.NST > length) {
+        return false;
+    }
+
+    // FL counts the words of the STC, EOH, FIC and subchannels, and is
+    // followed by the EOF and TIST
+    size_t words = fc.NST + 1;
+    if (fc.FICF) {
+        words += (fc.MID == 3) ? 32 : 24;
+    }
+    for (size_t i = 0; i < fc.NST; ++i) {
+        eti_STC stc;
+        memcpy(&stc, frame + 8 + 4 * i, sizeof(stc));
+        words += stc.getSTL() * 2;
+    }
+    return fc.getFrameLength() == words && 8 + 4 * words + 8 <= 6144;
+}
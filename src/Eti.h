@@ -133,4 +133,20 @@ struct eti_extension_TIME {
 } PACKED;
 
 
+#include <sys/types.h>
+
+// Offset of the first ETI sync word (either of the two alternating ones)
+// in data, or length if there is none
+size_t findEtiSync(const uint8_t* data, size_t length);
+
+// Checks that a frame starts with a sync word followed by an FC and STC
+// whose frame length matches the FIC and subchannels they describe.
+// length is the number of bytes available at frame.
+bool isEtiFrameStart(const uint8_t* frame, size_t length);
+
+// CRC of the header and of the MST as stored in the EOH and EOF: CCITT
+// polynomial x^16 + x^12 + x^5 + 1, initial value 0xffff, inverted.
+uint16_t etiCrc16(const uint8_t* data, size_t length);
+
+
 #endif // ETI_H
@@ -0,0 +1,251 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EtiIndex.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <algorithm>
+
+
+EtiIndex::EtiIndex() :
+    myFileLength(0),
+    myFileTime(0),
+    myFileInode(0),
+    myStreamType(ETI_STREAM_TYPE_NONE)
+{
+}
+
+
+void EtiIndex::getSourceId(const struct stat& source, uint64_t& length,
+        uint64_t& time, uint64_t& inode)
+{
+    length = source.st_size;
+    time = (uint64_t)source.st_mtim.tv_sec * 1000000000 +
+        source.st_mtim.tv_nsec;
+    inode = source.st_ino;
+}
+
+
+void EtiIndex::build(const uint8_t* data, const struct stat& source,
+        size_t start, EtiStreamType streamType)
+{
+    const size_t length = source.st_size;
+    PDEBUG("EtiIndex::build(%p, %zu, %zu, %u)\n",
+            data, length, start, streamType);
+
+    myEntries.clear();
+    getSourceId(source, myFileLength, myFileTime, myFileInode);
+    myStreamType = streamType;
+
+    // Raw frames have no size field
+    const bool raw = (streamType == ETI_STREAM_TYPE_RAW);
+    struct tm time;
+    bool timeValid = false;
+    uint32_t seconds = 0;
+
+    size_t offset = start;
+    while (offset < length) {
+        eti_index_entry entry;
+        entry.offset = offset;
+        entry.rfu = 0;
+
+        size_t frame = offset;
+        if (raw) {
+            entry.size = 6144;
+        }
+        else {
+            if (offset + sizeof(entry.size) > length) {
+                break;
+            }
+            memcpy(&entry.size, data + offset, sizeof(entry.size));
+            frame += sizeof(entry.size);
+        }
+        if (entry.size > 6144 || entry.size < 12 ||
+                frame + entry.size > length) {
+            break;
+        }
+        offset = frame + entry.size;
+
+        eti_FC fc;
+        memcpy(&fc, data + frame + 4, sizeof(fc));
+        entry.fct = fc.FCT;
+
+        eti_EOH eoh;
+        size_t eohOffset = 8 + 4 * fc.NST;
+        if (eohOffset + sizeof(eoh) <= entry.size) {
+            memcpy(&eoh, data + frame + eohOffset, sizeof(eoh));
+
+            // Same decoding as the TimestampDecoder, one part of the time
+            // in each frame phase
+            uint16_t mnsc = eoh.MNSC;
+            switch (fc.FP & 0x3) {
+            case 0: {
+                const eti_MNSC_TIME_0* mnsc0 = (const eti_MNSC_TIME_0*)&mnsc;
+                timeValid = (mnsc0->type == 0) && (mnsc0->identifier == 0);
+                memset(&time, 0, sizeof(time));
+                break;
+            }
+            case 1: {
+                const eti_MNSC_TIME_1* mnsc1 = (const eti_MNSC_TIME_1*)&mnsc;
+                time.tm_sec = mnsc1->second_tens * 10 + mnsc1->second_unit;
+                time.tm_min = mnsc1->minute_tens * 10 + mnsc1->minute_unit;
+                if (!mnsc1->sync_to_frame) {
+                    timeValid = false;
+                }
+                break;
+            }
+            case 2: {
+                const eti_MNSC_TIME_2* mnsc2 = (const eti_MNSC_TIME_2*)&mnsc;
+                time.tm_hour = mnsc2->hour_tens * 10 + mnsc2->hour_unit;
+                time.tm_mday = mnsc2->day_tens * 10 + mnsc2->day_unit;
+                break;
+            }
+            case 3: {
+                const eti_MNSC_TIME_3* mnsc3 = (const eti_MNSC_TIME_3*)&mnsc;
+                time.tm_mon = (mnsc3->month_tens * 10 +
+                        mnsc3->month_unit) - 1;
+                time.tm_year = (mnsc3->year_tens * 10 +
+                        mnsc3->year_unit) + 100;
+                if (timeValid) {
+                    seconds = timegm(&time);
+                }
+                break;
+            }
+            }
+        }
+        entry.seconds = seconds;
+
+        // The TIST follows the STC, EOH and MST (FL words) and the EOF
+        size_t tistOffset = 8 + 4 * fc.getFrameLength() + 4;
+        entry.tist = 0xFFFFFF;
+        if (tistOffset + 4 <= entry.size) {
+            uint32_t tist;
+            memcpy(&tist, data + frame + tistOffset, sizeof(tist));
+            entry.tist = ntohl(tist) & 0xFFFFFF;
+        }
+
+        myEntries.push_back(entry);
+    }
+}
+
+
+bool EtiIndex::load(const std::string& filename, const struct stat& source,
+        EtiStreamType streamType)
+{
+    uint64_t fileLength;
+    uint64_t fileTime;
+    uint64_t fileInode;
+    getSourceId(source, fileLength, fileTime, fileInode);
+
+    FILE* file = fopen(filename.c_str(), "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    eti_index_header header;
+    bool valid = (fread(&header, sizeof(header), 1, file) == 1) &&
+        header.magic == ETI_INDEX_MAGIC &&
+        header.version == ETI_INDEX_VERSION &&
+        header.streamType == (uint32_t)streamType &&
+        header.fileLength == fileLength &&
+        header.fileTime == fileTime &&
+        header.fileInode == fileInode;
+    if (valid) {
+        myEntries.resize(header.nbEntries);
+        valid = header.nbEntries == 0 ||
+            fread(&myEntries[0], sizeof(eti_index_entry), header.nbEntries,
+                    file) == header.nbEntries;
+    }
+    fclose(file);
+
+    if (!valid) {
+        myEntries.clear();
+        return false;
+    }
+    myFileLength = fileLength;
+    myFileTime = fileTime;
+    myFileInode = fileInode;
+    myStreamType = streamType;
+    return true;
+}
+
+
+bool EtiIndex::save(const std::string& filename) const
+{
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == NULL) {
+        perror(filename.c_str());
+        return false;
+    }
+
+    eti_index_header header;
+    header.magic = ETI_INDEX_MAGIC;
+    header.version = ETI_INDEX_VERSION;
+    header.streamType = myStreamType;
+    header.nbEntries = myEntries.size();
+    header.fileLength = myFileLength;
+    header.fileTime = myFileTime;
+    header.fileInode = myFileInode;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+        (myEntries.empty() ||
+         fwrite(&myEntries[0], sizeof(eti_index_entry), myEntries.size(),
+             file) == myEntries.size());
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        perror(filename.c_str());
+    }
+    return ok;
+}
+
+
+double EtiIndex::frameTime(const eti_index_entry& entry)
+{
+    if (entry.seconds == 0) {
+        return 0;
+    }
+    double time = entry.seconds;
+    if (entry.tist != 0xFFFFFF) {
+        time += entry.tist / 16384000.0;
+    }
+    return time;
+}
+
+
+static bool frameBefore(const eti_index_entry& entry, double time)
+{
+    return EtiIndex::frameTime(entry) < time;
+}
+
+
+size_t EtiIndex::findTime(double time) const
+{
+    // The frames before the first complete MNSC time have time 0 and sort
+    // first, the recording is assumed not to go back in time
+    return std::lower_bound(myEntries.begin(), myEntries.end(), time,
+            frameBefore) - myEntries.begin();
+}
@@ -0,0 +1,117 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ETI_INDEX_H
+#define ETI_INDEX_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "Eti.h"
+#include "InputReader.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+#define ETI_INDEX_MAGIC 0x58444945 // "EIDX"
+#define ETI_INDEX_VERSION 2
+
+struct eti_index_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t streamType;
+    uint32_t nbEntries;
+    // Length, modification time (ns since the epoch) and inode of the
+    // indexed file. Any difference means a stale index, e.g. when a
+    // recording was replaced by another one of the same length.
+    uint64_t fileLength;
+    uint64_t fileTime;
+    uint64_t fileInode;
+} PACKED;
+
+struct eti_index_entry {
+    // Offset of the frame in the file, including its frame size field
+    uint64_t offset;
+    // MNSC time of the frame in seconds since the epoch (UTC), 0 until
+    // the first complete time has been received
+    uint32_t seconds;
+    // TIST of the frame in 1/16384000 s, 0xFFFFFF if not present
+    uint32_t tist;
+    uint16_t size;
+    uint8_t fct;
+    uint8_t rfu;
+} PACKED;
+
+
+/* Index of the frames of an ETI file, with their offset, FCT and time.
+ * It is built in one pass over the mapped file and can be kept next to
+ * it, so that the reader can start at any frame or time without reading
+ * the file from the start.
+ */
+class EtiIndex
+{
+public:
+    EtiIndex();
+
+    // Indexes the frames of the file described by source and mapped at
+    // data, starting at offset start. Frames of a raw file have no frame
+    // size field.
+    void build(const uint8_t* data, const struct stat& source, size_t start,
+            EtiStreamType streamType);
+
+    // Returns false if the file does not exist or is not an index of this
+    // very source file and stream type
+    bool load(const std::string& filename, const struct stat& source,
+            EtiStreamType streamType);
+    bool save(const std::string& filename) const;
+
+    size_t size() const { return myEntries.size(); }
+    bool empty() const { return myEntries.empty(); }
+    const eti_index_entry& operator[](size_t frame) const {
+        return myEntries[frame];
+    }
+
+    // First frame at or after the given time, size() if there is none
+    size_t findTime(double time) const;
+
+    // Time of a frame in seconds, 0 if unknown
+    static double frameTime(const eti_index_entry& entry);
+
+protected:
+    // Identifies the source file of the index
+    static void getSourceId(const struct stat& source, uint64_t& length,
+            uint64_t& time, uint64_t& inode);
+
+    std::vector<eti_index_entry> myEntries;
+    uint64_t myFileLength;
+    uint64_t myFileTime;
+    uint64_t myFileInode;
+    EtiStreamType myStreamType;
+};
+
+
+#endif // ETI_INDEX_H
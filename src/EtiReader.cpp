@@ -27,7 +27,9 @@
 #include "PcDebug.h"
 #include "TimestampDecoder.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <sstream>
 #include <sys/types.h>
 #include <string.h>
 #include <arpa/inet.h>
@@ -49,15 +51,26 @@ enum ETI_READER_STATE {
 
 
 EtiReader::EtiReader(struct modulator_offset_config& modconf,
-        Logger& logger) :
+        Logger& logger, std::string rcName) :
+    RemoteControllable(rcName),
     myLogger(logger),
     state(EtiReaderStateSync),
     myFicSource(NULL),
-    myTimestampDecoder(modconf, myLogger)
+    myTimestampDecoder(modconf, myLogger),
+    myCrcPolicy(ETI_CRC_LOG),
+    myMuted(false),
+    myHeaderErrors(0),
+    myMstErrors(0)
 {
     PDEBUG("EtiReader::EtiReader()\n");
 
     myCurrentFrame = 0;
+    memset(myLastMnsc, 0, sizeof(myLastMnsc));
+
+    RC_ADD_PARAMETER(crc, "Policy for frames with CRC errors: off, log, mute or repeat.");
+    RC_ADD_PARAMETER(headererrors, "(Read-only) frames with a header CRC error.");
+    RC_ADD_PARAMETER(msterrors, "(Read-only) frames with an MST CRC error.");
+    RC_ADD_PARAMETER(subchannelerrors, "(Read-only) MST CRC errors by subchannel, as SCId:count.");
 }
 
 EtiReader::~EtiReader()
@@ -104,6 +117,26 @@ int EtiReader::process(Buffer* dataIn)
     const unsigned char* in = reinterpret_cast<const unsigned char*>(dataIn->getData());
     size_t input_size = dataIn->getLength();
 
+    // Complete frames are decoded directly, the state machine only
+    // handles partial input. A frame received on its own can end right
+    // after its TIST, without the padding.
+    while (state == EtiReaderStateSync && input_size >= 8) {
+        size_t size = std::min(input_size, (size_t)6144);
+        if (size < 6144) {
+            eti_FC fc;
+            memcpy(&fc, in + 4, sizeof(fc));
+            size_t frameLength = fc.getFrameLength();
+            size_t ficWords = (fc.MID == 3) ? 32 : 24;
+            if (frameLength < fc.NST + 1 + ficWords ||
+                    size < 8 + 4 * frameLength + 8) {
+                break;
+            }
+        }
+        processFrame(in, size);
+        input_size -= size;
+        in += size;
+    }
+
     while (input_size > 0) {
         switch (state) {
         case EtiReaderStateNbFrame:
@@ -143,46 +176,17 @@ int EtiReader::process(Buffer* dataIn)
             if (input_size < 4) {
                 return dataIn->getLength() - input_size;
             }
-            memcpy(&eti_fc, in, 4);
+            processFc(in);
             input_size -= 4;
             framesize -= 4;
             in += 4;
             state = EtiReaderStateNst;
-            PDEBUG("Fc.fct: 0x%.2x\n", eti_fc.FCT);
-            PDEBUG("Fc.ficf: %u\n", eti_fc.FICF);
-            PDEBUG("Fc.nst: %u\n", eti_fc.NST);
-            PDEBUG("Fc.fp: 0x%x\n", eti_fc.FP);
-            PDEBUG("Fc.mid: %u\n", eti_fc.MID);
-            PDEBUG("Fc.fl: %u\n", eti_fc.getFrameLength());
-            if (!eti_fc.FICF) {
-                throw std::runtime_error("FIC must be present to modulate!");
-            }
-            if (myFicSource == NULL) {
-                myFicSource = new FicSource(eti_fc);
-            }
             break;
         case EtiReaderStateNst:
             if (input_size < 4 * (size_t)eti_fc.NST) {
                 return dataIn->getLength() - input_size;
             }
-            if ((eti_stc.size() != eti_fc.NST) ||
-                    (memcmp(&eti_stc[0], in, 4 * eti_fc.NST))) {
-                PDEBUG("New stc!\n");
-                eti_stc.resize(eti_fc.NST);
-                for (unsigned i = 0; i < mySources.size(); ++i) {
-                    delete mySources[i];
-                }
-                mySources.resize(eti_fc.NST);
-                memcpy(&eti_stc[0], in, 4 * eti_fc.NST);
-                for (unsigned i = 0; i < eti_fc.NST; ++i) {
-                    mySources[i] = new SubchannelSource(eti_stc[i]);
-                    PDEBUG("Sstc %u:\n", i);
-                    PDEBUG(" Stc%i.scid: %i\n", i, eti_stc[i].SCID);
-                    PDEBUG(" Stc%i.sad: %u\n", i, eti_stc[i].getStartAddress());
-                    PDEBUG(" Stc%i.tpl: 0x%.2x\n", i, eti_stc[i].TPL);
-                    PDEBUG(" Stc%i.stl: %u\n", i, eti_stc[i].getSTL());
-                }
-            }
+            processStc(in);
             input_size -= 4 * eti_fc.NST;
             framesize -= 4 * eti_fc.NST;
             in += 4 * eti_fc.NST;
@@ -201,34 +205,32 @@ int EtiReader::process(Buffer* dataIn)
             PDEBUG("Eoh.crc: 0x%.4x\n", eti_eoh.CRC);
             break;
         case EtiReaderStateFic:
-            if (eti_fc.MID == 3) {
-                if (input_size < 128) {
-                    return dataIn->getLength() - input_size;
-                }
-                PDEBUG("Writting 128 bytes of FIC channel data\n");
-                Buffer fic = Buffer(128, in);
-                myFicSource->process(&fic, NULL);
-                input_size -= 128;
-                framesize -= 128;
-                in += 128;
-            } else {
-                if (input_size < 96) {
-                    return dataIn->getLength() - input_size;
-                }
-                PDEBUG("Writting 96 bytes of FIC channel data\n");
-                Buffer fic = Buffer(96, in);
-                myFicSource->process(&fic, NULL);
-                input_size -= 96;
-                framesize -= 96;
-                in += 96;
+            if (input_size < (eti_fc.MID == 3 ? 128 : 96)) {
+                return dataIn->getLength() - input_size;
+            }
+            {
+                size_t size = processFic(in);
+                input_size -= size;
+                framesize -= size;
+                in += size;
             }
             state = EtiReaderStateSubch;
             break;
         case EtiReaderStateSubch:
+            {
+                size_t size = 0;
+                for (size_t i = 0; i < eti_stc.size(); ++i) {
+                    size += mySources[i]->framesize();
+                }
+                if (input_size < size) {
+                    return dataIn->getLength() - input_size;
+                }
+            }
             for (size_t i = 0; i < eti_stc.size(); ++i) {
                 unsigned size = mySources[i]->framesize();
                 PDEBUG("Writting %i bytes of subchannel data\n", size);
-                Buffer subch = Buffer(size, in);
+                Buffer subch;
+                subch.setExternalData(in, size);
                 mySources[i]->process(&subch, NULL);
                 input_size -= size;
                 framesize -= size;
@@ -260,11 +262,13 @@ int EtiReader::process(Buffer* dataIn)
             PDEBUG("Tist: 0x%.6x\n", eti_tist.TIST);
             break;
         case EtiReaderStatePad:
-            if (framesize > 0) {
-                --input_size;
-                --framesize;
-                ++in;
-            } else {
+            {
+                size_t size = framesize < input_size ? framesize : input_size;
+                input_size -= size;
+                framesize -= size;
+                in += size;
+            }
+            if (framesize == 0) {
                 state = EtiReaderStateSync;
             }
             break;
@@ -275,7 +279,232 @@ int EtiReader::process(Buffer* dataIn)
         }
     }
     
-    // Update timestamps
+    updateTimestamps();
+
+    return dataIn->getLength() - input_size;
+}
+
+
+void EtiReader::processFrame(const unsigned char* in, size_t size)
+{
+    PDEBUG("EtiReader::processFrame(in: %p, size: %zu)\n", in, size);
+
+    EtiCrcPolicy policy;
+    {
+        boost::mutex::scoped_lock lock(myCrcMutex);
+        policy = myCrcPolicy;
+    }
+
+    myMuted = false;
+    if (policy != ETI_CRC_OFF) {
+        bool headerOk;
+        bool conceal = (policy == ETI_CRC_MUTE || policy == ETI_CRC_REPEAT);
+        if (checkCrc(in, size, headerOk)) {
+            if (conceal) {
+                eti_FC fc;
+                memcpy(&fc, in + 4, sizeof(fc));
+                myLastFrame.assign(in, in + size);
+                myLastFrame.resize(6144, 0x55);
+                memcpy(&myLastMnsc[fc.FP], in + 8 + 4 * fc.NST, 2);
+            }
+        }
+        else if (conceal) {
+            // Corrupted data is not modulated, it would stay on air
+            // through the time interleaving even if this frame is muted
+            myMuted = (policy == ETI_CRC_MUTE);
+            if (!myLastFrame.empty()) {
+                const unsigned char* frame = concealFrame(in, size, headerOk);
+                if (frame != in) {
+                    in = frame;
+                    size = myConcealedFrame.size();
+                }
+            }
+        }
+    }
+
+    const unsigned char* const end = in + size;
+
+    memcpy(&eti_sync, in, 4);
+    processFc(in + 4);
+    in += 8;
+
+    processStc(in);
+    in += 4 * eti_fc.NST;
+
+    memcpy(&eti_eoh, in, 4);
+    in += 4;
+
+    in += processFic(in);
+
+    size_t subchSize = 0;
+    for (size_t i = 0; i < eti_stc.size(); ++i) {
+        subchSize += mySources[i]->framesize();
+    }
+    if (in + subchSize + 8 > end) {
+        throw std::runtime_error("EtiReader: subchannels exceed ETI frame!");
+    }
+    for (size_t i = 0; i < eti_stc.size(); ++i) {
+        unsigned size = mySources[i]->framesize();
+        Buffer subch;
+        subch.setExternalData(in, size);
+        mySources[i]->process(&subch, NULL);
+        in += size;
+    }
+
+    memcpy(&eti_eof, in, 4);
+    memcpy(&eti_tist, in + 4, 4);
+    PDEBUG("Tist: 0x%.6x\n", eti_tist.TIST);
+    // The padding up to end is not read
+}
+
+
+bool EtiReader::checkCrc(const unsigned char* in, size_t size,
+        bool& headerOk)
+{
+    eti_FC fc;
+    memcpy(&fc, in + 4, sizeof(fc));
+
+    // The header CRC covers the FC, STC and MNSC, the MST CRC the FIC and
+    // the subchannels
+    const unsigned char* eoh = in + 8 + 4 * fc.NST;
+    headerOk = etiCrc16(in + 4, eoh + 2 - (in + 4)) ==
+        ((eoh[2] << 8) | eoh[3]);
+
+    bool mstOk = false;
+    size_t mstSize = 0;
+    if (headerOk && fc.getFrameLength() > fc.NST) {
+        mstSize = 4 * (fc.getFrameLength() - fc.NST - 1);
+        const unsigned char* eof = eoh + 4 + mstSize;
+        mstOk = eof + 8 <= in + size &&
+            etiCrc16(eoh + 4, mstSize) == ((eof[0] << 8) | eof[1]);
+    }
+    if (headerOk && mstOk) {
+        return true;
+    }
+
+    boost::mutex::scoped_lock lock(myCrcMutex);
+    if (!headerOk) {
+        ++myHeaderErrors;
+        myLogger.level(warn) << "ETI header CRC error in frame " <<
+            fc.FCT << " (" << myHeaderErrors << " in total)";
+    }
+    else {
+        ++myMstErrors;
+        for (size_t i = 0; i < fc.NST; ++i) {
+            eti_STC stc;
+            memcpy(&stc, in + 8 + 4 * i, sizeof(stc));
+            ++mySubchannelErrors[stc.SCID];
+        }
+        myLogger.level(warn) << "ETI MST CRC error in frame " <<
+            fc.FCT << " (" << myMstErrors << " in total)";
+    }
+    return false;
+}
+
+
+const unsigned char* EtiReader::concealFrame(const unsigned char* in,
+        size_t size, bool headerOk)
+{
+    const unsigned char* last = &myLastFrame[0];
+    myConcealedFrame.resize(6144);
+    unsigned char* frame = &myConcealedFrame[0];
+
+    eti_FC fc;
+    eti_FC lastFc;
+    memcpy(&fc, in + 4, sizeof(fc));
+    memcpy(&lastFc, last + 4, sizeof(lastFc));
+    size_t lastMstSize = 4 * (lastFc.getFrameLength() - lastFc.NST - 1);
+
+    if (headerOk) {
+        // Keep the header of the frame with its counters and time, the
+        // MST is at the same place as long as the subchannels are the same
+        if (fc.NST != lastFc.NST || fc.MID != lastFc.MID ||
+                fc.getFrameLength() != lastFc.getFrameLength() ||
+                memcmp(in + 8, last + 8, 4 * fc.NST) != 0) {
+            return in;
+        }
+        memcpy(frame, in, size);
+        memcpy(frame + 8 + 4 * fc.NST + 4, last + 8 + 4 * fc.NST + 4,
+                lastMstSize);
+        return frame;
+    }
+
+    // Nothing in the header can be trusted, repeat the whole last good
+    // frame and continue the counters and time of the previous one
+    memcpy(frame, last, 6144);
+    lastFc.FCT = (eti_fc.FCT + 1) % 250;
+    lastFc.FP = (eti_fc.FP + 1) % 8;
+    memcpy(frame + 4, &lastFc, sizeof(lastFc));
+
+    unsigned char* eoh = frame + 8 + 4 * lastFc.NST;
+    memcpy(eoh, &myLastMnsc[lastFc.FP], 2);
+
+    uint32_t tist = ntohl(eti_tist.TIST);
+    if ((tist & 0xffffff) != 0xffffff) {
+        // One frame is 24 ms in units of 1/16384000 s
+        tist = (tist & 0xff000000) |
+            (((tist & 0xffffff) + 393216) % 16384000);
+        tist = htonl(tist);
+        memcpy(eoh + 4 + lastMstSize + 4, &tist, 4);
+    }
+    return frame;
+}
+
+
+void EtiReader::processFc(const unsigned char* in)
+{
+    memcpy(&eti_fc, in, 4);
+    PDEBUG("Fc.fct: 0x%.2x\n", eti_fc.FCT);
+    PDEBUG("Fc.ficf: %u\n", eti_fc.FICF);
+    PDEBUG("Fc.nst: %u\n", eti_fc.NST);
+    PDEBUG("Fc.fp: 0x%x\n", eti_fc.FP);
+    PDEBUG("Fc.mid: %u\n", eti_fc.MID);
+    PDEBUG("Fc.fl: %u\n", eti_fc.getFrameLength());
+    if (!eti_fc.FICF) {
+        throw std::runtime_error("FIC must be present to modulate!");
+    }
+    if (myFicSource == NULL) {
+        myFicSource = new FicSource(eti_fc);
+    }
+}
+
+
+void EtiReader::processStc(const unsigned char* in)
+{
+    if ((eti_stc.size() != eti_fc.NST) ||
+            (memcmp(&eti_stc[0], in, 4 * eti_fc.NST))) {
+        PDEBUG("New stc!\n");
+        eti_stc.resize(eti_fc.NST);
+        for (unsigned i = 0; i < mySources.size(); ++i) {
+            delete mySources[i];
+        }
+        mySources.resize(eti_fc.NST);
+        memcpy(&eti_stc[0], in, 4 * eti_fc.NST);
+        for (unsigned i = 0; i < eti_fc.NST; ++i) {
+            mySources[i] = new SubchannelSource(eti_stc[i]);
+            PDEBUG("Sstc %u:\n", i);
+            PDEBUG(" Stc%i.scid: %i\n", i, eti_stc[i].SCID);
+            PDEBUG(" Stc%i.sad: %u\n", i, eti_stc[i].getStartAddress());
+            PDEBUG(" Stc%i.tpl: 0x%.2x\n", i, eti_stc[i].TPL);
+            PDEBUG(" Stc%i.stl: %u\n", i, eti_stc[i].getSTL());
+        }
+    }
+}
+
+
+size_t EtiReader::processFic(const unsigned char* in)
+{
+    size_t size = (eti_fc.MID == 3) ? 128 : 96;
+    PDEBUG("Writting %zu bytes of FIC channel data\n", size);
+    Buffer fic;
+    fic.setExternalData(in, size);
+    myFicSource->process(&fic, NULL);
+    return size;
+}
+
+
+void EtiReader::updateTimestamps()
+{
     myTimestampDecoder.updateTimestampEti(eti_fc.FP & 0x3,
             eti_eoh.MNSC, 
             getPPSOffset());
@@ -284,8 +513,53 @@ int EtiReader::process(Buffer* dataIn)
     {
         myTimestampDecoder.updateModulatorOffset();
     }
+}
 
-    return dataIn->getLength() - input_size;
+
+void EtiReader::processSplitFrame(Buffer* dataIn, Buffer* fic, Buffer* cif)
+{
+    PDEBUG("EtiReader::processSplitFrame(dataIn: %p)\n", dataIn);
+
+    const unsigned char* in =
+        reinterpret_cast<const unsigned char*>(dataIn->getData());
+    struct split_frame_header header;
+
+    if (dataIn->getLength() < sizeof(header)) {
+        throw std::runtime_error(
+                "EtiReader::processSplitFrame frame too short!");
+    }
+    memcpy(&header, in, sizeof(header));
+    if (ntohl(header.magic) != SPLIT_FRAME_MAGIC) {
+        throw std::runtime_error(
+                "EtiReader::processSplitFrame invalid split frame!");
+    }
+
+    size_t ficSize = ntohs(header.ficSize);
+    size_t cifSize = ntohs(header.cifSize);
+    if (dataIn->getLength() < sizeof(header) + ficSize + cifSize) {
+        throw std::runtime_error(
+                "EtiReader::processSplitFrame frame too short!");
+    }
+
+    eti_fc = header.fc;
+    eti_eoh = header.eoh;
+    eti_tist = header.tist;
+    myMuted = (ntohl(header.flags) & SPLIT_FRAME_MUTED) != 0;
+
+    fic->setData(in + sizeof(header), ficSize);
+    cif->setData(in + sizeof(header) + ficSize, cifSize);
+
+    updateTimestamps();
+}
+
+
+void EtiReader::getSplitHeader(struct split_frame_header& header)
+{
+    header.magic = htonl(SPLIT_FRAME_MAGIC);
+    header.fc = eti_fc;
+    header.eoh = eti_eoh;
+    header.tist = eti_tist;
+    header.flags = htonl(myMuted ? SPLIT_FRAME_MUTED : 0);
 }
 
 bool EtiReader::sourceContainsTimestamp()
@@ -310,3 +584,96 @@ uint32_t EtiReader::getFCT()
 {
     return eti_fc.FCT;
 }
+
+
+void EtiReader::setCrcPolicy(EtiCrcPolicy policy)
+{
+    boost::mutex::scoped_lock lock(myCrcMutex);
+    myCrcPolicy = policy;
+}
+
+
+EtiCrcPolicy EtiReader::parseCrcPolicy(const std::string& name)
+{
+    if (name == "off") {
+        return ETI_CRC_OFF;
+    }
+    else if (name == "log") {
+        return ETI_CRC_LOG;
+    }
+    else if (name == "mute") {
+        return ETI_CRC_MUTE;
+    }
+    else if (name == "repeat") {
+        return ETI_CRC_REPEAT;
+    }
+    throw std::invalid_argument("CRC policy '" + name +
+            "' must be off, log, mute or repeat");
+}
+
+
+const char* EtiReader::crcPolicyName(EtiCrcPolicy policy)
+{
+    switch (policy) {
+    case ETI_CRC_OFF:
+        return "off";
+    case ETI_CRC_LOG:
+        return "log";
+    case ETI_CRC_MUTE:
+        return "mute";
+    case ETI_CRC_REPEAT:
+        return "repeat";
+    }
+    return "";
+}
+
+
+void EtiReader::set_parameter(const string& parameter, const string& value)
+{
+    if (parameter == "crc") {
+        try {
+            setCrcPolicy(parseCrcPolicy(value));
+        }
+        catch (std::invalid_argument& e) {
+            throw ParameterError(e.what());
+        }
+    }
+    else if (parameter == "headererrors" || parameter == "msterrors" ||
+            parameter == "subchannelerrors") {
+        throw ParameterError("Parameter '" + parameter + "' is read-only");
+    }
+    else {
+        stringstream ss;
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+}
+
+
+const string EtiReader::get_parameter(const string& parameter) const
+{
+    stringstream ss;
+    boost::mutex::scoped_lock lock(myCrcMutex);
+    if (parameter == "crc") {
+        ss << crcPolicyName(myCrcPolicy);
+    }
+    else if (parameter == "headererrors") {
+        ss << myHeaderErrors;
+    }
+    else if (parameter == "msterrors") {
+        ss << myMstErrors;
+    }
+    else if (parameter == "subchannelerrors") {
+        std::map<unsigned, uint64_t>::const_iterator it;
+        for (it = mySubchannelErrors.begin();
+                it != mySubchannelErrors.end(); ++it) {
+            ss << (it == mySubchannelErrors.begin() ? "" : " ") <<
+                it->first << ":" << it->second;
+        }
+    }
+    else {
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+    return ss.str();
+}
@@ -35,16 +35,31 @@
 #include "FicSource.h"
 #include "SubchannelSource.h"
 #include "TimestampDecoder.h"
+#include "SplitFrame.h"
+#include "RemoteControl.h"
 
 #include <vector>
+#include <map>
+#include <string>
 #include <stdint.h>
 #include <sys/types.h>
+#include <boost/thread.hpp>
 
 
-class EtiReader
+/* What to do with frames whose header or MST CRC does not match */
+enum EtiCrcPolicy {
+    ETI_CRC_OFF,        // CRCs are not verified
+    ETI_CRC_LOG,        // errors are counted and logged only
+    ETI_CRC_MUTE,       // the output of the frame is muted
+    ETI_CRC_REPEAT      // the contents of the last good frame are repeated
+};
+
+
+class EtiReader : public RemoteControllable
 {
 public:
-    EtiReader(struct modulator_offset_config& modconf, Logger& logger);
+    EtiReader(struct modulator_offset_config& modconf, Logger& logger,
+            std::string rcName = "etireader");
     virtual ~EtiReader();
     EtiReader(const EtiReader&);
     EtiReader& operator=(const EtiReader&);
@@ -55,6 +70,13 @@ public:
     const std::vector<SubchannelSource*>& getSubchannels();
     int process(Buffer* dataIn);
 
+    /* Read a split frame sent by a central coding instance instead of
+     * an ETI frame, and copy the coded FIC and CIF into fic and cif */
+    void processSplitFrame(Buffer* dataIn, Buffer* fic, Buffer* cif);
+
+    /* Fill the ETI fields of a split frame header for the current frame */
+    void getSplitHeader(struct split_frame_header& header);
+
     void calculateTimestamp(struct frame_timestamp& ts)
     {
         myTimestampDecoder.calculateTimestamp(ts);
@@ -66,6 +88,22 @@ public:
     /* Returns true if we have valid time stamps in the ETI*/
     bool sourceContainsTimestamp();
 
+    void setCrcPolicy(EtiCrcPolicy policy);
+
+    /* Returns true if the output of the last frame must be muted */
+    bool isMuted() { return myMuted; }
+
+    /* Policy names used in the configuration and the remote control,
+     * parseCrcPolicy throws std::invalid_argument for unknown names */
+    static EtiCrcPolicy parseCrcPolicy(const std::string& name);
+    static const char* crcPolicyName(EtiCrcPolicy policy);
+
+    /******* REMOTE CONTROL ********/
+    virtual void set_parameter(const string& parameter,
+            const string& value);
+
+    virtual const string get_parameter(const string& parameter) const;
+
 protected:
     /* Main program logger */
     Logger& myLogger;
@@ -74,6 +112,25 @@ protected:
     double getPPSOffset();
 
     void sync();
+    void updateTimestamps();
+
+    /* Decode a complete ETI(NI) frame in one pass. size is 6144 bytes, or
+     * less when the padding is missing. */
+    void processFrame(const unsigned char* in, size_t size);
+
+    /* Helpers shared by processFrame and the state machine */
+    void processFc(const unsigned char* in);
+    void processStc(const unsigned char* in);
+    size_t processFic(const unsigned char* in);
+
+    /* Verify the header and MST CRCs of a complete frame and count the
+     * errors. Returns false if either does not match. */
+    bool checkCrc(const unsigned char* in, size_t size, bool& headerOk);
+
+    /* Build the frame to decode in place of a corrupted one from the last
+     * good frame, according to the policy */
+    const unsigned char* concealFrame(const unsigned char* in,
+            size_t size, bool headerOk);
     int state;
     uint32_t nb_frames;
     uint16_t framesize;
@@ -89,6 +146,19 @@ protected:
     
 private:
     size_t myCurrentFrame;
+
+    EtiCrcPolicy myCrcPolicy;
+    bool myMuted;
+    std::vector<unsigned char> myLastFrame;
+    std::vector<unsigned char> myConcealedFrame;
+    uint16_t myLastMnsc[8]; // of the last good frames, by frame phase
+
+    // Error counters, read by the remote control
+    mutable boost::mutex myCrcMutex;
+    uint64_t myHeaderErrors;
+    uint64_t myMstErrors;
+    std::map<unsigned, uint64_t> mySubchannelErrors; // by SCId
+
     bool time_ext_enabled;
     unsigned long timestamp_seconds;
 };
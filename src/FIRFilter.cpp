@@ -298,9 +298,9 @@ void FIRFilterWorker::process(struct FIRFilterWorkerData *fwd)
 }
 
 
-FIRFilter::FIRFilter(std::string taps_file) :
+FIRFilter::FIRFilter(std::string taps_file, std::string rcName) :
     ModCodec(ModFormat(sizeof(complexf)), ModFormat(sizeof(complexf))),
-    RemoteControllable("firfilter"),
+    RemoteControllable(rcName),
     myTapsFile(taps_file)
 {
     PDEBUG("FIRFilter::FIRFilter(%s) @ %p\n",
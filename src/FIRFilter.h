@@ -99,7 +99,7 @@ class FIRFilterWorker {
 class FIRFilter : public ModCodec, public RemoteControllable
 {
 public:
-    FIRFilter(std::string taps_file);
+    FIRFilter(std::string taps_file, std::string rcName = "firfilter");
     virtual ~FIRFilter();
     FIRFilter(const FIRFilter&);
     FIRFilter& operator=(const FIRFilter&);
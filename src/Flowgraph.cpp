@@ -20,6 +20,7 @@
  */
 
 #include "Flowgraph.h"
+#include "Numa.h"
 #include "PcDebug.h"
 
 
@@ -45,7 +46,10 @@ typedef std::vector<Edge*>::iterator EdgeIterator;
 
 Node::Node(ModPlugin* plugin) :
     myPlugin(plugin),
-    myProcessTime(0)
+    myProcessTime(0),
+    myConstant(false),
+    myDone(false),
+    myRemoteFrames(0)
 {
     PDEBUG("Node::Node(plugin(%s): %p) @ %p\n", plugin->name(), plugin, this);
 
@@ -112,12 +116,38 @@ int Node::process()
     PDEBUG("Edge::process()\n");
     PDEBUG(" Plugin name: %s (%p)\n", myPlugin->name(), myPlugin);
 
-    return myPlugin->process(myInputBuffers, myOutputBuffers);
+    int ret = myPlugin->process(myInputBuffers, myOutputBuffers);
+    myDone = (ret != 0);
+    return ret;
+}
+
+
+void Node::checkNode(int cpuNode)
+{
+    myBufferAddresses.resize(myOutputBuffers.size(), NULL);
+    myBufferNodes.resize(myOutputBuffers.size(), -1);
+
+    for (size_t i = 0; i < myOutputBuffers.size(); ++i) {
+        const void* data = myOutputBuffers[i]->getData();
+        if (data == NULL) {
+            continue;
+        }
+        if (data != myBufferAddresses[i]) {
+            myBufferAddresses[i] = data;
+            myBufferNodes[i] = numaAddressNode(data);
+        }
+        if (myBufferNodes[i] >= 0 && myBufferNodes[i] != cpuNode) {
+            ++myRemoteFrames;
+            break;
+        }
+    }
 }
 
 
 Flowgraph::Flowgraph() :
-    myProcessTime(0)
+    myProcessTime(0),
+    myConstantsFolded(false),
+    myNuma(numaNodeCount() > 1)
 {
     PDEBUG("Flowgraph::Flowgraph() @ %p\n", this);
 
@@ -133,10 +163,18 @@ Flowgraph::~Flowgraph()
         delete *edge;
     }
 
+    std::vector<Node*>::const_iterator node;
+    if (myNuma) {
+        fprintf(stderr, "Frames with buffers on another NUMA node:\n");
+        for (node = nodes.begin(); node != nodes.end(); ++node) {
+            fprintf(stderr, "  %30s: %10lu\n", (*node)->plugin()->name(),
+                    (*node)->remoteFrames());
+        }
+    }
+
     if (myProcessTime) {
         fprintf(stderr, "Process time:\n");
     }
-    std::vector<Node*>::const_iterator node;
     for (node = nodes.begin(); node != nodes.end(); ++node) {
         if (myProcessTime) {
             fprintf(stderr, "  %30s: %10u us (%2.2f %%)\n",
@@ -197,6 +235,26 @@ void Flowgraph::connect(ModPlugin* input, ModPlugin* output)
     assert((*outputNode)->plugin() == output);
 
     edges.push_back(new Edge(*inputNode, *outputNode));
+    myConstantsFolded = false;
+}
+
+
+void Flowgraph::foldConstants()
+{
+    // Nodes are sorted so that every node comes after its inputs
+    for (NodeIterator node = nodes.begin(); node != nodes.end(); ++node) {
+        bool constant = (*node)->plugin()->isConstant();
+        for (EdgeIterator edge = edges.begin(); edge != edges.end(); ++edge) {
+            if ((*edge)->dstNode() == *node &&
+                    !(*edge)->srcNode()->isConstant()) {
+                constant = false;
+            }
+        }
+        (*node)->setConstant(constant);
+        PDEBUG(" %s is %s\n", (*node)->plugin()->name(),
+                constant ? "constant" : "variable");
+    }
+    myConstantsFolded = true;
 }
 
 
@@ -208,9 +266,21 @@ bool Flowgraph::run()
     timeval start, stop;
     time_t diff;
 
+    if (!myConstantsFolded) {
+        foldConstants();
+    }
+
+    int cpuNode = myNuma ? numaCurrentNode() : -1;
+
     gettimeofday(&start, NULL);
     for (node = nodes.begin(); node != nodes.end(); ++node) {
+        if ((*node)->isConstant() && (*node)->isDone()) {
+            continue;
+        }
         int ret = (*node)->process();
+        if (cpuNode >= 0) {
+            (*node)->checkNode(cpuNode);
+        }
         PDEBUG(" ret: %i\n", ret);
         gettimeofday(&stop, NULL);
         diff = (stop.tv_sec - start.tv_sec) * 1000000 +
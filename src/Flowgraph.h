@@ -48,14 +48,28 @@ public:
     std::vector<Buffer*> myOutputBuffers;
 
     int process();
+    bool isConstant() { return myConstant; }
+    void setConstant(bool constant) { myConstant = constant; }
+    bool isDone() { return myDone; }
     time_t processTime() { return myProcessTime; }
     void addProcessTime(time_t processTime) {
         myProcessTime += processTime;
     }
+    // Counts the frame if an output buffer is not on the given NUMA node
+    void checkNode(int cpuNode);
+    unsigned long remoteFrames() { return myRemoteFrames; }
 
 protected:
     ModPlugin* myPlugin;
     time_t myProcessTime;
+    // Constant nodes keep their output buffers and only run once
+    bool myConstant;
+    bool myDone;
+    // NUMA node of each output buffer, looked up again when the data of
+    // the buffer moves
+    std::vector<const void*> myBufferAddresses;
+    std::vector<int> myBufferNodes;
+    unsigned long myRemoteFrames;
 };
 
 
@@ -67,6 +81,9 @@ public:
     Edge(const Edge&);
     Edge& operator=(const Edge&);
 
+    Node* srcNode() { return mySrcNode; }
+    Node* dstNode() { return myDstNode; }
+
 protected:
     Node* mySrcNode;
     Node* myDstNode;
@@ -86,9 +103,14 @@ public:
     bool run();
 
 protected:
+    void foldConstants();
+
     std::vector<Node*> nodes;
     std::vector<Edge*> edges;
     time_t myProcessTime;
+    bool myConstantsFolded;
+    // Only check the placement of the buffers on NUMA hosts
+    bool myNuma;
 };
 
 
@@ -0,0 +1,274 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FormatConverter.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <stdexcept>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+
+// Saturation limits and offset of each integer format, in output units.
+// The modulator samples are converted without scaling, the digital gain
+// has to be chosen so that they fit the range of the selected format.
+template<SampleFormat format> struct FormatLimits;
+
+template<> struct FormatLimits<FORMAT_SC16> {
+    typedef int16_t sample_t;
+    static float min() { return -32768.0f; }
+    static float max() { return 32767.0f; }
+    static float offset() { return 0.0f; }
+};
+
+template<> struct FormatLimits<FORMAT_SC8> {
+    typedef int8_t sample_t;
+    static float min() { return -128.0f; }
+    static float max() { return 127.0f; }
+    static float offset() { return 0.0f; }
+};
+
+template<> struct FormatLimits<FORMAT_U8> {
+    typedef uint8_t sample_t;
+    static float min() { return 0.0f; }
+    static float max() { return 255.0f; }
+    static float offset() { return 128.0f; }
+};
+
+
+static inline uint32_t xorshift32(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+
+// Uniform value in [0, 1) from the 23 upper bits of a random word
+static inline float uniform(uint32_t value)
+{
+    union {
+        uint32_t i;
+        float f;
+    } u;
+    u.i = (value >> 9) | 0x3f800000;
+    return u.f - 1.0f;
+}
+
+
+#ifdef __SSE2__
+static inline __m128i xorshift32(__m128i& state)
+{
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+    state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+    return state;
+}
+
+
+static inline __m128 uniform(__m128i value)
+{
+    const __m128i one = _mm_set1_epi32(0x3f800000);
+    return _mm_sub_ps(
+            _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(value, 9), one)),
+            _mm_set1_ps(1.0f));
+}
+#endif
+
+
+FormatConverter::FormatConverter(SampleFormat format, bool dither) :
+    ModCodec(ModFormat(sizeof(complexf)), ModFormat(sampleSize(format))),
+    myFormat(format),
+    myDither(dither)
+{
+    PDEBUG("FormatConverter::FormatConverter(%s, %i) @ %p\n",
+            formatName(format), dither, this);
+
+    switch (format) {
+    case FORMAT_SC16:
+        convertKernel = dither ?
+            &FormatConverter::convert<FORMAT_SC16, true> :
+            &FormatConverter::convert<FORMAT_SC16, false>;
+        break;
+    case FORMAT_SC8:
+        convertKernel = dither ?
+            &FormatConverter::convert<FORMAT_SC8, true> :
+            &FormatConverter::convert<FORMAT_SC8, false>;
+        break;
+    case FORMAT_U8:
+        convertKernel = dither ?
+            &FormatConverter::convert<FORMAT_U8, true> :
+            &FormatConverter::convert<FORMAT_U8, false>;
+        break;
+    default:
+        throw std::runtime_error(
+                "FormatConverter::FormatConverter invalid output format!");
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        myDitherState[i] = 0x9e3779b9u * (i + 1);
+    }
+}
+
+
+FormatConverter::~FormatConverter()
+{
+    PDEBUG("FormatConverter::~FormatConverter() @ %p\n", this);
+}
+
+
+SampleFormat FormatConverter::parseFormat(const std::string& format)
+{
+    if (format == "complexf") {
+        return FORMAT_COMPLEXF;
+    }
+    else if (format == "sc16") {
+        return FORMAT_SC16;
+    }
+    else if (format == "sc8") {
+        return FORMAT_SC8;
+    }
+    else if (format == "u8") {
+        return FORMAT_U8;
+    }
+    throw std::runtime_error("FormatConverter: unknown sample format " +
+            format + "!");
+}
+
+
+const char* FormatConverter::formatName(SampleFormat format)
+{
+    switch (format) {
+    case FORMAT_COMPLEXF:
+        return "complexf";
+    case FORMAT_SC16:
+        return "sc16";
+    case FORMAT_SC8:
+        return "sc8";
+    case FORMAT_U8:
+        return "u8";
+    }
+    return "unknown";
+}
+
+
+size_t FormatConverter::sampleSize(SampleFormat format)
+{
+    switch (format) {
+    case FORMAT_COMPLEXF:
+        return sizeof(complexf);
+    case FORMAT_SC16:
+        return 2 * sizeof(int16_t);
+    case FORMAT_SC8:
+    case FORMAT_U8:
+        return 2 * sizeof(int8_t);
+    }
+    return 0;
+}
+
+
+// Converts length floats (I and Q count separately). Dither is
+// triangular, the difference of two uniform values, spanning +/- 1 LSB.
+// Rounding is to nearest, which is what both _mm_cvtps_epi32 and lrintf
+// do in the default rounding mode.
+template<SampleFormat format, bool dither>
+void FormatConverter::convert(const float* in, void* out, size_t length)
+{
+    typedef FormatLimits<format> limits;
+    typedef typename limits::sample_t sample_t;
+    sample_t* samples = reinterpret_cast<sample_t*>(out);
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 min = _mm_set1_ps(limits::min());
+    const __m128 max = _mm_set1_ps(limits::max());
+    const __m128 offset = _mm_set1_ps(limits::offset());
+    __m128i state = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(myDitherState));
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i value[4];
+        for (size_t j = 0; j < 4; ++j) {
+            __m128 x = _mm_add_ps(_mm_loadu_ps(&in[i + 4 * j]), offset);
+            if (dither) {
+                __m128 u1 = uniform(xorshift32(state));
+                __m128 u2 = uniform(xorshift32(state));
+                x = _mm_add_ps(x, _mm_sub_ps(u1, u2));
+            }
+            // Clamp before converting, out of range values would
+            // otherwise become 0x80000000
+            x = _mm_min_ps(_mm_max_ps(x, min), max);
+            value[j] = _mm_cvtps_epi32(x);
+        }
+        // The values are already in range, packing does not saturate
+        __m128i lo = _mm_packs_epi32(value[0], value[1]);
+        __m128i hi = _mm_packs_epi32(value[2], value[3]);
+        __m128i* dst = reinterpret_cast<__m128i*>(&samples[i]);
+        if (format == FORMAT_SC16) {
+            _mm_storeu_si128(dst, lo);
+            _mm_storeu_si128(dst + 1, hi);
+        }
+        else if (format == FORMAT_SC8) {
+            _mm_storeu_si128(dst, _mm_packs_epi16(lo, hi));
+        }
+        else {
+            _mm_storeu_si128(dst, _mm_packus_epi16(lo, hi));
+        }
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(myDitherState), state);
+#endif
+
+    for (; i < length; ++i) {
+        float x = in[i] + limits::offset();
+        if (dither) {
+            float u1 = uniform(xorshift32(myDitherState[0]));
+            float u2 = uniform(xorshift32(myDitherState[0]));
+            x += u1 - u2;
+        }
+        if (x < limits::min()) {
+            x = limits::min();
+        }
+        else if (x > limits::max()) {
+            x = limits::max();
+        }
+        samples[i] = (sample_t)lrintf(x);
+    }
+}
+
+
+int FormatConverter::process(Buffer* const dataIn, Buffer* dataOut)
+{
+    PDEBUG("FormatConverter::process(dataIn: %p, dataOut: %p)\n",
+            dataIn, dataOut);
+
+    size_t sizeIn = dataIn->getLength() / sizeof(complexf);
+    dataOut->setLength(sizeIn * sampleSize(myFormat));
+
+    (this->*convertKernel)(reinterpret_cast<const float*>(dataIn->getData()),
+            dataOut->getData(), sizeIn * 2);
+
+    return dataOut->getLength();
+}
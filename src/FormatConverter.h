@@ -0,0 +1,78 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FORMAT_CONVERTER_H
+#define FORMAT_CONVERTER_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModCodec.h"
+
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+#include <complex>
+
+typedef std::complex<float> complexf;
+
+
+enum SampleFormat {
+    FORMAT_COMPLEXF,    // 32-bit float I/Q, as produced by the modulator
+    FORMAT_SC16,        // interleaved signed 16-bit I/Q
+    FORMAT_SC8,         // interleaved signed 8-bit I/Q
+    FORMAT_U8,          // interleaved offset-binary 8-bit I/Q
+};
+
+
+class FormatConverter : public ModCodec
+{
+public:
+    FormatConverter(SampleFormat format, bool dither = false);
+    virtual ~FormatConverter();
+    FormatConverter(const FormatConverter&);
+    FormatConverter& operator=(const FormatConverter&);
+
+    static SampleFormat parseFormat(const std::string& format);
+    static const char* formatName(SampleFormat format);
+    // Size in bytes of one complex sample
+    static size_t sampleSize(SampleFormat format);
+
+    int process(Buffer* const dataIn, Buffer* dataOut);
+    const char* name() { return "FormatConverter"; }
+
+protected:
+    template<SampleFormat format, bool dither>
+    void convert(const float* in, void* out, size_t length);
+
+    void (FormatConverter::*convertKernel)(const float*, void*, size_t);
+
+    SampleFormat myFormat;
+    bool myDither;
+    // Four xorshift32 generators, one per SSE lane
+    uint32_t myDitherState[4];
+};
+
+
+#endif // FORMAT_CONVERTER_H
@@ -26,10 +26,22 @@
 #include <stdexcept>
 #include <malloc.h>
 #include <complex>
+#include <map>
+#include <boost/thread/mutex.hpp>
 
 typedef std::complex<float> complexf;
 
 
+// The permutation only depends on the mode, the interleavers of all
+// modulators in the process share one table per mode.
+struct SharedIndexes {
+    size_t* indexes;
+    size_t users;
+};
+static std::map<size_t, SharedIndexes> sharedIndexes;
+static boost::mutex sharedIndexesMutex;
+
+
 FrequencyInterleaver::FrequencyInterleaver(size_t mode) :
     ModCodec(ModFormat(0), ModFormat(0))
 {
@@ -44,22 +56,26 @@ FrequencyInterleaver::FrequencyInterleaver(size_t mode) :
         d_carriers = 1536;
         num = 2048;
         beta = 511;
+        d_interleaveSymbol = interleaveSymbol<1536>;
         break;
     case 2:
         d_carriers = 384;
         num = 512;
         beta = 127;
+        d_interleaveSymbol = interleaveSymbol<384>;
         break;
     case 3:
         d_carriers = 192;
         num = 256;
         beta = 63;
+        d_interleaveSymbol = interleaveSymbol<192>;
         break;
     case 0:
     case 4:
         d_carriers = 768;
         num = 1024;
         beta = 255;
+        d_interleaveSymbol = interleaveSymbol<768>;
         break;
     default:
         PDEBUG("Carriers: %zu\n", (d_carriers >> 1) << 1);
@@ -68,7 +84,17 @@ FrequencyInterleaver::FrequencyInterleaver(size_t mode) :
         break;
     }
 
+    d_num = num;
+
+    boost::mutex::scoped_lock lock(sharedIndexesMutex);
+    SharedIndexes& shared = sharedIndexes[d_carriers];
+    if (shared.users++ > 0) {
+        d_indexes = shared.indexes;
+        return;
+    }
+
     d_indexes = (size_t*)memalign(16, d_carriers * sizeof(size_t));
+    shared.indexes = d_indexes;
     size_t* index = d_indexes;
     size_t perm = 0;
     PDEBUG("i: %4u, R: %4u\n", 0, 0);
@@ -95,7 +121,26 @@ FrequencyInterleaver::~FrequencyInterleaver()
 {
     PDEBUG("FrequencyInterleaver::~FrequencyInterleaver() @ %p\n", this);
 
-    free(d_indexes);
+    boost::mutex::scoped_lock lock(sharedIndexesMutex);
+    std::map<size_t, SharedIndexes>::iterator it =
+        sharedIndexes.find(d_carriers);
+    if (it != sharedIndexes.end() && --it->second.users == 0) {
+        free(it->second.indexes);
+        sharedIndexes.erase(it);
+    }
+}
+
+
+template<size_t carriers>
+void FrequencyInterleaver::interleaveSymbol(const size_t* indexes,
+        const complexf* in, complexf* out)
+{
+    for (size_t j = 0; j < carriers; j += 4) {
+        out[indexes[j]] = in[j];
+        out[indexes[j + 1]] = in[j + 1];
+        out[indexes[j + 2]] = in[j + 2];
+        out[indexes[j + 3]] = in[j + 3];
+    }
 }
 
 
@@ -116,14 +161,9 @@ int FrequencyInterleaver::process(Buffer* const dataIn, Buffer* dataOut)
                 "FrequencyInterleaver::process input size not valid!");
     }
 
-    for (size_t i = 0; i < sizeIn;) {
-//        memset(out, 0, d_carriers * sizeof(complexf));
-        for (size_t j = 0; j < d_carriers; i += 4, j += 4) {
-            out[d_indexes[j]] = in[i];
-            out[d_indexes[j + 1]] = in[i + 1];
-            out[d_indexes[j + 2]] = in[i + 2];
-            out[d_indexes[j + 3]] = in[i + 3];
-        }
+    for (size_t i = 0; i < sizeIn; i += d_carriers) {
+        d_interleaveSymbol(d_indexes, in, out);
+        in += d_carriers;
         out += d_carriers;
     }
 
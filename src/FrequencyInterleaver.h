@@ -30,6 +30,7 @@
 #include "ModCodec.h"
 
 #include <sys/types.h>
+#include <complex>
 
 
 class FrequencyInterleaver : public ModCodec
@@ -48,6 +49,14 @@ protected:
     size_t d_carriers;
     size_t d_num;
     size_t* d_indexes;
+
+    // Interleaves one OFDM symbol, instantiated for the carriers of each
+    // mode
+    void (*d_interleaveSymbol)(const size_t* indexes,
+            const std::complex<float>* in, std::complex<float>* out);
+    template<size_t carriers>
+    static void interleaveSymbol(const size_t* indexes,
+            const std::complex<float>* in, std::complex<float>* out);
 };
 
 #endif // FREQUENCY_INTERLEAVER_H
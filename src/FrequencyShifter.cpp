@@ -0,0 +1,215 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrequencyShifter.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#ifdef __SSE__
+#   include <xmmintrin.h>
+#endif
+
+
+// The oscillator runs on a complex recurrence within a block, and is
+// restarted from the exact phase at the beginning of each block. This
+// bounds the drift of the recurrence while keeping sin and cos out of
+// the per-sample loop.
+static const size_t BLOCK_SIZE = 1024;
+
+
+#ifdef __SSE__
+// Two complex products per register
+static inline __m128 complexMultiply(__m128 a, __m128 b)
+{
+    const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    __m128 re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 swap = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(_mm_mul_ps(a, re),
+            _mm_xor_ps(_mm_mul_ps(swap, im), sign));
+}
+#endif
+
+
+static inline complexf rotation(double cycles)
+{
+    return complexf(cos(2.0 * M_PI * cycles), sin(2.0 * M_PI * cycles));
+}
+
+
+FrequencyShifter::FrequencyShifter(double offset, unsigned sampleRate,
+        std::string rcName) :
+    ModCodec(ModFormat(sizeof(complexf)), ModFormat(sizeof(complexf))),
+    RemoteControllable(rcName),
+    mySampleRate(sampleRate),
+    myOffset(offset),
+    myPhase(0.0)
+{
+    PDEBUG("FrequencyShifter::FrequencyShifter(%f, %u) @ %p\n",
+            offset, sampleRate, this);
+
+    RC_ADD_PARAMETER(offset, "Frequency offset in Hz, applied at the next frame.");
+
+    checkOffset(offset);
+    setIncrement(offset);
+}
+
+
+FrequencyShifter::~FrequencyShifter()
+{
+    PDEBUG("FrequencyShifter::~FrequencyShifter() @ %p\n", this);
+}
+
+
+void FrequencyShifter::checkOffset(double offset) const
+{
+    if (fabs(offset) >= mySampleRate / 2.0) {
+        std::stringstream ss;
+        ss << "FrequencyShifter: offset " << offset <<
+            " Hz is outside of the output bandwidth";
+        throw std::runtime_error(ss.str());
+    }
+}
+
+
+void FrequencyShifter::setIncrement(double offset)
+{
+    myAppliedOffset = offset;
+    myIncrement = offset / mySampleRate;
+    for (size_t k = 0; k < 4; ++k) {
+        myLaneRotation[k] = rotation(k * myIncrement);
+    }
+    myStep = rotation(4 * myIncrement);
+}
+
+
+void FrequencyShifter::shiftBlock(const complexf* in, complexf* out,
+        size_t length)
+{
+    const complexf start = rotation(myPhase);
+    complexf rot[4];
+    for (size_t k = 0; k < 4; ++k) {
+        rot[k] = start * myLaneRotation[k];
+    }
+
+    size_t i = 0;
+#ifdef __SSE__
+    __m128 rot01 = _mm_loadu_ps(reinterpret_cast<const float*>(&rot[0]));
+    __m128 rot23 = _mm_loadu_ps(reinterpret_cast<const float*>(&rot[2]));
+    const __m128 step = _mm_setr_ps(myStep.real(), myStep.imag(),
+            myStep.real(), myStep.imag());
+    for (; i + 4 <= length; i += 4) {
+        const float* src = reinterpret_cast<const float*>(&in[i]);
+        float* dst = reinterpret_cast<float*>(&out[i]);
+        _mm_storeu_ps(dst, complexMultiply(_mm_loadu_ps(src), rot01));
+        _mm_storeu_ps(dst + 4, complexMultiply(_mm_loadu_ps(src + 4), rot23));
+        rot01 = complexMultiply(rot01, step);
+        rot23 = complexMultiply(rot23, step);
+    }
+    _mm_storeu_ps(reinterpret_cast<float*>(&rot[0]), rot01);
+    _mm_storeu_ps(reinterpret_cast<float*>(&rot[2]), rot23);
+#else
+    for (; i + 4 <= length; i += 4) {
+        for (size_t k = 0; k < 4; ++k) {
+            out[i + k] = in[i + k] * rot[k];
+            rot[k] *= myStep;
+        }
+    }
+#endif
+    for (size_t k = 0; i < length; ++i, ++k) {
+        out[i] = in[i] * rot[k];
+    }
+}
+
+
+int FrequencyShifter::process(Buffer* const dataIn, Buffer* dataOut)
+{
+    PDEBUG("FrequencyShifter::process(dataIn: %p, dataOut: %p)\n",
+            dataIn, dataOut);
+
+    dataOut->setLength(dataIn->getLength());
+
+    const complexf* in = reinterpret_cast<const complexf*>(dataIn->getData());
+    complexf* out = reinterpret_cast<complexf*>(dataOut->getData());
+    size_t sizeIn = dataIn->getLength() / sizeof(complexf);
+
+    // A new offset only changes the increment, the phase carries over
+    {
+        boost::mutex::scoped_lock lock(myMutex);
+        if (myOffset != myAppliedOffset) {
+            setIncrement(myOffset);
+        }
+    }
+
+    for (size_t i = 0; i < sizeIn; i += BLOCK_SIZE) {
+        size_t length = std::min(BLOCK_SIZE, sizeIn - i);
+        shiftBlock(&in[i], &out[i], length);
+        myPhase += length * myIncrement;
+        myPhase -= floor(myPhase);
+    }
+
+    return dataOut->getLength();
+}
+
+
+void FrequencyShifter::set_parameter(const string& parameter,
+        const string& value)
+{
+    stringstream ss(value);
+    ss.exceptions ( stringstream::failbit | stringstream::badbit );
+
+    if (parameter == "offset") {
+        double offset;
+        ss >> offset;
+        try {
+            checkOffset(offset);
+        }
+        catch (std::runtime_error &e) {
+            throw ParameterError(e.what());
+        }
+        boost::mutex::scoped_lock lock(myMutex);
+        myOffset = offset;
+    }
+    else {
+        stringstream ss;
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+}
+
+
+const string FrequencyShifter::get_parameter(const string& parameter) const
+{
+    stringstream ss;
+    if (parameter == "offset") {
+        boost::mutex::scoped_lock lock(myMutex);
+        ss << myOffset;
+    }
+    else {
+        ss << "Parameter '" << parameter << "' is not exported by controllable " << get_rc_name();
+        throw ParameterError(ss.str());
+    }
+    return ss.str();
+}
@@ -0,0 +1,86 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FREQUENCY_SHIFTER_H
+#define FREQUENCY_SHIFTER_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModCodec.h"
+#include "RemoteControl.h"
+
+#include <boost/thread.hpp>
+#include <sys/types.h>
+#include <complex>
+#include <string>
+
+typedef std::complex<float> complexf;
+
+
+/* Shifts the signal by a digital frequency offset, by multiplying it
+ * with a numerically controlled oscillator. The offset can be changed
+ * through the remote control, and is applied at the next frame boundary
+ * without phase discontinuity.
+ */
+class FrequencyShifter : public ModCodec, public RemoteControllable
+{
+public:
+    FrequencyShifter(double offset, unsigned sampleRate,
+            std::string rcName = "freqshift");
+    virtual ~FrequencyShifter();
+    FrequencyShifter(const FrequencyShifter&);
+    FrequencyShifter& operator=(const FrequencyShifter&);
+
+    int process(Buffer* const dataIn, Buffer* dataOut);
+    const char* name() { return "FrequencyShifter"; }
+
+    /******* REMOTE CONTROL ********/
+    virtual void set_parameter(const string& parameter, const string& value);
+    virtual const string get_parameter(const string& parameter) const;
+
+protected:
+    void checkOffset(double offset) const;
+    void setIncrement(double offset);
+    void shiftBlock(const complexf* in, complexf* out, size_t length);
+
+    unsigned mySampleRate;
+
+    // Offset requested through the remote control, protected by myMutex
+    double myOffset;
+    mutable boost::mutex myMutex;
+
+    // Offset currently applied
+    double myAppliedOffset;
+    // Phase increment per sample and phase at the start of the next
+    // block, both in cycles
+    double myIncrement;
+    double myPhase;
+    // Rotation of the four SIMD lanes relative to the first one, and
+    // rotation applied to each lane after four samples
+    complexf myLaneRotation[4];
+    complexf myStep;
+};
+
+
+#endif // FREQUENCY_SHIFTER_H
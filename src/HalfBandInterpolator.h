@@ -0,0 +1,75 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+
+   This block interpolates by 2, 4 or 8 with a cascade of half-band
+   FIR sections. Each section only computes the non-zero taps of the
+   polyphase branch that needs filtering, and folds the symmetric taps.
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HALF_BAND_INTERPOLATOR_H
+#define HALF_BAND_INTERPOLATOR_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModCodec.h"
+
+
+#include <sys/types.h>
+#include <vector>
+#include <complex>
+
+typedef std::complex<float> complexf;
+
+
+struct HalfBandSection {
+    // Number of distinct non-zero coefficients, the filter has 4K-1 taps
+    size_t K;
+    std::vector<float> coefs;
+    // 2K-1 samples of history followed by the section input
+    std::vector<complexf> buffer;
+};
+
+
+class HalfBandInterpolator : public ModCodec
+{
+public:
+    HalfBandInterpolator(size_t factor);
+    virtual ~HalfBandInterpolator();
+    HalfBandInterpolator(const HalfBandInterpolator&);
+    HalfBandInterpolator& operator=(const HalfBandInterpolator&);
+
+    static bool isSupported(size_t factor);
+
+    int process(Buffer* const dataIn, Buffer* dataOut);
+    const char* name() { return "HalfBandInterpolator"; }
+
+protected:
+    void filterSection(HalfBandSection& section, size_t sizeIn,
+            complexf* out);
+
+    size_t myFactor;
+    std::vector<HalfBandSection> mySections;
+};
+
+
+#endif // HALF_BAND_INTERPOLATOR_H
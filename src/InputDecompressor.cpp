@@ -0,0 +1,412 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include "InputDecompressor.h"
+#include "PcDebug.h"
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <stdexcept>
+#include <algorithm>
+
+// About one second of ETI(NI) per block, and eight blocks ahead
+#define BLOCK_SIZE (42 * 6144)
+#define QUEUE_DEPTH 8
+
+static const uint8_t GZIP_MAGIC[2] = { 0x1f, 0x8b };
+static const uint8_t ZSTD_MAGIC[4] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+
+CompressionType InputDecompressor::Identify(const std::string& filename)
+{
+    // Pipes cannot be peeked at without losing the data
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0 ||
+            !S_ISREG(fileStat.st_mode)) {
+        return COMPRESSION_NONE;
+    }
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return COMPRESSION_NONE;
+    }
+    uint8_t magic[4];
+    ssize_t length = pread(fd, magic, sizeof(magic), 0);
+    close(fd);
+
+    if (length >= 4 && memcmp(magic, ZSTD_MAGIC, 4) == 0) {
+        return COMPRESSION_ZSTD;
+    }
+    if (length >= 2 && memcmp(magic, GZIP_MAGIC, 2) == 0) {
+        return COMPRESSION_GZIP;
+    }
+    return COMPRESSION_NONE;
+}
+
+
+const char* InputDecompressor::Name(CompressionType type)
+{
+    switch (type) {
+    case COMPRESSION_GZIP:
+        return "gzip";
+    case COMPRESSION_ZSTD:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+
+FILE* InputDecompressor::Open(FILE* file, CompressionType type)
+{
+#if !defined(HAVE_LIBZ)
+    if (type == COMPRESSION_GZIP) {
+        return NULL;
+    }
+#endif
+#if !defined(HAVE_LIBZSTD)
+    if (type == COMPRESSION_ZSTD) {
+        return NULL;
+    }
+#endif
+    if (type == COMPRESSION_NONE) {
+        return NULL;
+    }
+
+    InputDecompressor* decompressor = new InputDecompressor(file, type);
+
+    cookie_io_functions_t functions;
+    functions.read = CookieRead;
+    functions.write = NULL;
+    functions.seek = CookieSeek;
+    functions.close = CookieClose;
+    FILE* stream = fopencookie(decompressor, "r", functions);
+    if (stream == NULL) {
+        // The file stays with the caller
+        decompressor->file_ = NULL;
+        delete decompressor;
+        return NULL;
+    }
+    decompressor->Start();
+    return stream;
+}
+
+
+InputDecompressor::InputDecompressor(FILE* file, CompressionType type) :
+    file_(file),
+    type_(type),
+    error_(false),
+    blockOffset_(0),
+    blockPos_(0),
+    end_(false)
+{
+    PDEBUG("InputDecompressor::InputDecompressor(%s) @ %p\n",
+            Name(type), this);
+
+#if defined(HAVE_LIBZ)
+    memset(&zlib_, 0, sizeof(zlib_));
+    // Detect the gzip header
+    if (type_ == COMPRESSION_GZIP && inflateInit2(&zlib_, 15 + 32) != Z_OK) {
+        throw std::runtime_error("InputDecompressor: unable to init zlib");
+    }
+    memberEnd_ = false;
+#endif
+#if defined(HAVE_LIBZSTD)
+    zstd_ = NULL;
+    if (type_ == COMPRESSION_ZSTD) {
+        zstd_ = ZSTD_createDStream();
+        if (zstd_ == NULL || ZSTD_isError(ZSTD_initDStream(zstd_))) {
+            throw std::runtime_error("InputDecompressor: unable to init zstd");
+        }
+    }
+    zstdIn_.src = in_;
+    zstdIn_.size = 0;
+    zstdIn_.pos = 0;
+#endif
+}
+
+
+InputDecompressor::~InputDecompressor()
+{
+    PDEBUG("InputDecompressor::~InputDecompressor() @ %p\n", this);
+
+    Stop();
+
+#if defined(HAVE_LIBZ)
+    if (type_ == COMPRESSION_GZIP) {
+        inflateEnd(&zlib_);
+    }
+#endif
+#if defined(HAVE_LIBZSTD)
+    if (zstd_ != NULL) {
+        ZSTD_freeDStream(zstd_);
+    }
+#endif
+    if (file_ != NULL) {
+        fclose(file_);
+    }
+}
+
+
+ssize_t InputDecompressor::CookieRead(void* cookie, char* buf, size_t size)
+{
+    return static_cast<InputDecompressor*>(cookie)->Read(buf, size);
+}
+
+
+int InputDecompressor::CookieSeek(void* cookie, off64_t* offset, int whence)
+{
+    return static_cast<InputDecompressor*>(cookie)->Seek(offset, whence);
+}
+
+
+int InputDecompressor::CookieClose(void* cookie)
+{
+    delete static_cast<InputDecompressor*>(cookie);
+    return 0;
+}
+
+
+ssize_t InputDecompressor::Read(char* buf, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+        if (!block_ || blockPos_ == block_->getLength()) {
+            if (end_) {
+                break;
+            }
+            boost::shared_ptr<Buffer> next;
+            queue_.wait_and_pop(next);
+            if (!next) {
+                end_ = true;
+                break;
+            }
+            if (block_) {
+                blockOffset_ += block_->getLength();
+            }
+            block_ = next;
+            blockPos_ = 0;
+        }
+
+        size_t length = std::min(size - done,
+                block_->getLength() - blockPos_);
+        memcpy(buf + done, (uint8_t*)block_->getData() + blockPos_, length);
+        blockPos_ += length;
+        done += length;
+    }
+
+    if (done == 0 && error_) {
+        errno = EIO;
+        return -1;
+    }
+    return done;
+}
+
+
+int InputDecompressor::Seek(off64_t* offset, int whence)
+{
+    uint64_t position = blockOffset_ + blockPos_;
+    off64_t target;
+    if (whence == SEEK_SET) {
+        target = *offset;
+    }
+    else if (whence == SEEK_CUR) {
+        target = position + *offset;
+    }
+    else {
+        // The length is not known before the end
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (target == 0 && position != 0) {
+        Restart();
+    }
+    else if (target != (off64_t)position) {
+        // Only the current block is still there
+        if (!block_ || target < (off64_t)blockOffset_ ||
+                target > (off64_t)(blockOffset_ + block_->getLength())) {
+            errno = ESPIPE;
+            return -1;
+        }
+        blockPos_ = target - blockOffset_;
+    }
+    *offset = target;
+    return 0;
+}
+
+
+void InputDecompressor::Restart()
+{
+    PDEBUG("InputDecompressor::Restart()\n");
+
+    Stop();
+
+    block_.reset();
+    blockOffset_ = 0;
+    blockPos_ = 0;
+    end_ = false;
+    error_ = false;
+
+    rewind(file_);
+#if defined(HAVE_LIBZ)
+    if (type_ == COMPRESSION_GZIP) {
+        inflateReset(&zlib_);
+        zlib_.avail_in = 0;
+        memberEnd_ = false;
+    }
+#endif
+#if defined(HAVE_LIBZSTD)
+    if (type_ == COMPRESSION_ZSTD) {
+        ZSTD_initDStream(zstd_);
+        zstdIn_.size = 0;
+        zstdIn_.pos = 0;
+    }
+#endif
+
+    Start();
+}
+
+
+void InputDecompressor::Start()
+{
+    thread_ = boost::thread(&InputDecompressor::Process, this);
+}
+
+
+void InputDecompressor::Stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    // The thread waits for room in the queue
+    thread_.interrupt();
+    thread_.join();
+
+    boost::shared_ptr<Buffer> block;
+    while (queue_.try_pop(block)) {
+    }
+}
+
+
+void InputDecompressor::Process()
+{
+    try {
+        while (true) {
+            boost::shared_ptr<Buffer> block(new Buffer(BLOCK_SIZE));
+            size_t length = Decompress((uint8_t*)block->getData(),
+                    BLOCK_SIZE);
+            if (length > 0) {
+                block->setLength(length);
+                queue_.push_wait_if_full(block, QUEUE_DEPTH);
+            }
+            if (length < BLOCK_SIZE) {
+                break;
+            }
+        }
+        queue_.push_wait_if_full(boost::shared_ptr<Buffer>(),
+                QUEUE_DEPTH + 1);
+    }
+    catch (boost::thread_interrupted&) {
+        PDEBUG("InputDecompressor::Process() interrupted\n");
+    }
+}
+
+
+size_t InputDecompressor::Decompress(uint8_t* data, size_t size)
+{
+#if defined(HAVE_LIBZ)
+    if (type_ == COMPRESSION_GZIP) {
+        zlib_.next_out = data;
+        zlib_.avail_out = size;
+        while (zlib_.avail_out > 0) {
+            if (zlib_.avail_in == 0) {
+                zlib_.next_in = in_;
+                zlib_.avail_in = fread(in_, 1, sizeof(in_), file_);
+                if (zlib_.avail_in == 0) {
+                    if (ferror(file_)) {
+                        perror("Unable to read compressed input file");
+                        error_ = true;
+                    }
+                    else if (!memberEnd_) {
+                        fprintf(stderr, "Compressed input file is "
+                                "truncated!\n");
+                    }
+                    break;
+                }
+            }
+
+            int ret = inflate(&zlib_, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                // Archives can be several concatenated gzip members
+                memberEnd_ = true;
+                inflateReset(&zlib_);
+            }
+            else if (ret == Z_OK) {
+                memberEnd_ = false;
+            }
+            else if (ret != Z_BUF_ERROR) {
+                fprintf(stderr, "Unable to decompress input file: %s\n",
+                        zlib_.msg ? zlib_.msg : "zlib error");
+                error_ = true;
+                break;
+            }
+        }
+        return size - zlib_.avail_out;
+    }
+#endif
+#if defined(HAVE_LIBZSTD)
+    if (type_ == COMPRESSION_ZSTD) {
+        ZSTD_outBuffer out = { data, size, 0 };
+        while (out.pos < out.size) {
+            if (zstdIn_.pos == zstdIn_.size) {
+                zstdIn_.size = fread(in_, 1, sizeof(in_), file_);
+                zstdIn_.pos = 0;
+                if (zstdIn_.size == 0) {
+                    if (ferror(file_)) {
+                        perror("Unable to read compressed input file");
+                        error_ = true;
+                    }
+                    break;
+                }
+            }
+
+            size_t ret = ZSTD_decompressStream(zstd_, &out, &zstdIn_);
+            if (ZSTD_isError(ret)) {
+                fprintf(stderr, "Unable to decompress input file: %s\n",
+                        ZSTD_getErrorName(ret));
+                error_ = true;
+                break;
+            }
+        }
+        return out.pos;
+    }
+#endif
+    return 0;
+}
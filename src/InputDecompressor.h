@@ -0,0 +1,120 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INPUT_DECOMPRESSOR_H
+#define INPUT_DECOMPRESSOR_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+#include "Buffer.h"
+#include "ThreadsafeQueue.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <string>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#if defined(HAVE_LIBZ)
+#   include <zlib.h>
+#endif
+#if defined(HAVE_LIBZSTD)
+#   include <zstd.h>
+#endif
+
+
+enum CompressionType {
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_ZSTD
+};
+
+/* Decompresses a gzip or zstd ETI recording on a readahead thread, and
+ * hands the data out through a stdio stream, so that the InputFileReader
+ * reads it like an uncompressed file. The stream can be rewound, and
+ * seeked back within the last decompressed block.
+ */
+class InputDecompressor
+{
+public:
+    // Compression of a regular file, from its magic number
+    static CompressionType Identify(const std::string& filename);
+
+    static const char* Name(CompressionType type);
+
+    // Returns a stream of the decompressed contents of file, which is
+    // closed with it, or NULL if this build does not support the type
+    static FILE* Open(FILE* file, CompressionType type);
+
+private:
+    InputDecompressor(FILE* file, CompressionType type);
+    ~InputDecompressor();
+    InputDecompressor(const InputDecompressor&);
+    InputDecompressor& operator=(const InputDecompressor&);
+
+    // The functions of the stream
+    static ssize_t CookieRead(void* cookie, char* buf, size_t size);
+    static int CookieSeek(void* cookie, off64_t* offset, int whence);
+    static int CookieClose(void* cookie);
+
+    ssize_t Read(char* buf, size_t size);
+    int Seek(off64_t* offset, int whence);
+
+    // Restart decompressing from the start of the file
+    void Restart();
+    void Start();
+    void Stop();
+
+    // Readahead thread
+    void Process();
+
+    // Decompress up to size bytes into data, returns the length written,
+    // less than size only at the end of the file or on error
+    size_t Decompress(uint8_t* data, size_t size);
+
+    FILE* file_;
+    CompressionType type_;
+
+    // Blocks decompressed ahead, an empty pointer ends the data
+    ThreadsafeQueue<boost::shared_ptr<Buffer> > queue_;
+    boost::thread thread_;
+    bool error_;
+
+    // Block being read, and its offset in the decompressed data
+    boost::shared_ptr<Buffer> block_;
+    uint64_t blockOffset_;
+    size_t blockPos_;
+    bool end_;
+
+    uint8_t in_[65536];
+#if defined(HAVE_LIBZ)
+    z_stream zlib_;
+    bool memberEnd_;
+#endif
+#if defined(HAVE_LIBZSTD)
+    ZSTD_DStream* zstd_;
+    ZSTD_inBuffer zstdIn_;
+#endif
+};
+
+#endif // INPUT_DECOMPRESSOR_H
@@ -38,9 +38,13 @@
 #include <cstring>
 #include <errno.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include "porting.h"
 #include "InputReader.h"
+#include "Eti.h"
+#include "Pipe.h"
 #include "PcDebug.h"
 
 int InputFileReader::Open(std::string filename, bool loop)
@@ -55,6 +59,33 @@ int InputFileReader::Open(std::string filename, bool loop)
         return -1;
     }
 
+    // Compressed recordings are read through a decompressing stream
+    compression_ = InputDecompressor::Identify(filename_);
+    if (compression_ != COMPRESSION_NONE) {
+        FILE* stream = InputDecompressor::Open(inputfile_, compression_);
+        if (stream == NULL) {
+            fprintf(stderr, "Input file is compressed with %s, which is not "
+                    "supported by this build!\n",
+                    InputDecompressor::Name(compression_));
+            logger_.level(error) << "Unsupported input file compression " <<
+                InputDecompressor::Name(compression_);
+            return -1;
+        }
+        inputfile_ = stream;
+    }
+    else if (isPipe(fileno(inputfile_))) {
+        pipebuffersize_ = setPipeSize(fileno(inputfile_), PIPE_BUFFER_SIZE);
+        if (pipebuffersize_ > 0 &&
+                posix_memalign((void**)&pipebuffer_, sysconf(_SC_PAGESIZE),
+                    pipebuffersize_) == 0) {
+            setvbuf(inputfile_, pipebuffer_, _IOFBF, pipebuffersize_);
+        }
+        else {
+            pipebuffer_ = NULL;
+            pipebuffersize_ = 0;
+        }
+    }
+
     return IdentifyType();
 }
 
@@ -68,9 +99,15 @@ int InputFileReader::IdentifyType()
 {
     EtiStreamType streamType = ETI_STREAM_TYPE_NONE;
 
+    // The decompressed length is not known in advance
     struct stat inputFileStat;
-    fstat(fileno(inputfile_), &inputFileStat);
-    inputfilelength_ = inputFileStat.st_size;
+    if (compression_ == COMPRESSION_NONE &&
+            fstat(fileno(inputfile_), &inputFileStat) == 0) {
+        inputfilelength_ = inputFileStat.st_size;
+    }
+    else {
+        inputfilelength_ = 0;
+    }
 
     uint32_t sync;
     uint32_t nbFrames;
@@ -163,36 +200,40 @@ int InputFileReader::IdentifyType()
         return 0;
     }
 
-    // Search for the sync marker byte by byte
-    for (size_t i = 10; i < 6144 + 10; ++i) {
-        sync >>= 8;
-        sync &= 0xffffff;
-        if (fread((uint8_t*)&sync + 3, 1, 1, inputfile_) != 1) {
-            fprintf(stderr, "Unable to read from input file!\n");
-            logger_.level(error) << "Unable to read from input file!";
-            perror(filename_.c_str());
-            return -1;
+    // Search for the first frame of a raw stream in the next block, after
+    // the last three bytes already read
+    uint8_t block[3 + 6144 + 512];
+    memcpy(block, (uint8_t*)&sync + 1, 3);
+    size_t length = 3 + fread(block + 3, 1, sizeof(block) - 3, inputfile_);
+    for (size_t offset = 0; offset < length; ++offset) {
+        offset += findEtiSync(block + offset, length - offset);
+        if (offset >= length ||
+                !isEtiFrameStart(block + offset, length - offset)) {
+            continue;
         }
-        if ((sync == 0x49c5f8ff) || (sync == 0xb63a07ff)) {
-            streamType = ETI_STREAM_TYPE_RAW;
-            if (inputfilelength_ > 0) {
-                nbframes_ = (inputfilelength_ - i) / 6144;
-            }
-            else {
-                nbframes_ = ~0;
-            }
-            if (fseek(inputfile_, -sizeof(sync), SEEK_CUR) != 0) {
-                if (fread(discard_buffer, 6144 - sizeof(sync), 1, inputfile_)
-                        != 1) {
-                    fprintf(stderr, "Unable to read from input file!\n");
-                    logger_.level(error) << "Unable to read from input file!";
-                    perror(filename_.c_str());
-                    return -1;
-                }
+
+        streamType = ETI_STREAM_TYPE_RAW;
+        if (inputfilelength_ > 0) {
+            nbframes_ = (inputfilelength_ - (7 + offset)) / 6144;
+        }
+        else {
+            nbframes_ = ~0;
+        }
+        // Bytes read after the start of the frame
+        size_t ahead = length - offset;
+        if (fseek(inputfile_, -(long)ahead, SEEK_CUR) != 0) {
+            // if the seek fails, consume the rest of the frame
+            size_t rest = (6144 - ahead % 6144) % 6144;
+            if (rest > 0 &&
+                    fread(discard_buffer, rest, 1, inputfile_) != 1) {
+                fprintf(stderr, "Unable to read from input file!\n");
+                logger_.level(error) << "Unable to read from input file!";
+                perror(filename_.c_str());
+                return -1;
             }
-            this->streamtype_ = streamType;
-            return 0;
         }
+        this->streamtype_ = streamType;
+        return 0;
     }
 
     fprintf(stderr, "Bad input file format!\n");
@@ -217,8 +258,15 @@ void InputFileReader::PrintInfo()
             fprintf(stderr, "unknown!");
             break;
     }
+    if (compression_ != COMPRESSION_NONE) {
+        fprintf(stderr, ", %s compressed",
+                InputDecompressor::Name(compression_));
+    }
     fprintf(stderr, "\n");
     fprintf(stderr, "Input file length: %zu\n", inputfilelength_);
+    if (pipebuffersize_ > 0) {
+        fprintf(stderr, "Input pipe buffer: %zu bytes\n", pipebuffersize_);
+    }
     if (~nbframes_ != 0) {
         fprintf(stderr, "Input file nb frames: %lu\n", nbframes_);
     }
@@ -293,7 +341,58 @@ int InputFileReader::GetNextFrame(void* buffer)
         return -1;
     }
 
+    // A raw stream carries no frame boundaries of its own, find the next
+    // valid frame after a corruption
+    if (streamtype_ == ETI_STREAM_TYPE_RAW &&
+            !isEtiFrameStart((uint8_t*)buffer, frameSize)) {
+        int ret = Resync((uint8_t*)buffer);
+        if (ret == 0 && loop_) {
+            if (Rewind() != 0) {
+                logger_.level(error) << "Impossible to rewind file!";
+                return -1;
+            }
+            return GetNextFrame(buffer);
+        }
+        if (ret <= 0) {
+            return ret;
+        }
+    }
+
     memset(&((uint8_t*)buffer)[frameSize], 0x55, 6144 - frameSize);
 
     return 6144;
 }
+
+int InputFileReader::Resync(uint8_t* buffer)
+{
+    uint64_t lost = 0;
+    int ret = 1;
+
+    do {
+        // Move to the next sync word, or keep the last three bytes that
+        // could be the start of one. The frame is validated once complete.
+        size_t offset = 1 + findEtiSync(buffer + 1, 6144 - 1);
+        if (offset > 6144 - 3) {
+            offset = 6144 - 3;
+        }
+        memmove(buffer, buffer + offset, 6144 - offset);
+        lost += offset;
+
+        if (fread(buffer + 6144 - offset, 1, offset, inputfile_) != offset) {
+            if (feof(inputfile_)) {
+                ret = 0;
+            }
+            else {
+                perror(filename_.c_str());
+                ret = -1;
+            }
+            break;
+        }
+    } while (!isEtiFrameStart(buffer, 6144));
+
+    lostbytes_ += lost;
+    fprintf(stderr, "Input lost sync, skipped %lu bytes "
+            "(%lu bytes lost in total)\n", lost, lostbytes_);
+    logger_.level(warn) << "Input lost sync, skipped " << lost << " bytes";
+    return ret;
+}
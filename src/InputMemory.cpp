@@ -55,7 +55,8 @@ int InputMemory::process(Buffer* dataIn, Buffer* dataOut)
             "(dataIn: %p, dataOut: %p)\n",
             dataIn, dataOut);
 
-    *dataOut = *myDataIn;
+    // The blocks only read their input, no need to copy it
+    dataOut->setExternalData(myDataIn->getData(), myDataIn->getLength());
 
     return dataOut->getLength();
 }
@@ -0,0 +1,479 @@
+/*
+   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+   Her Majesty the Queen in Right of Canada (Communications Research
+   Center Canada)
+
+   Copyrigth (C) 2013
+   Matthias P. Braendli, matthias.braendli@mpb.li
+
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "porting.h"
+#include "InputReader.h"
+#include "EtiIndex.h"
+#include "PcDebug.h"
+
+// How far ahead of the current frame the pages are faulted in
+#define READAHEAD_WINDOW (8 * 1024 * 1024)
+
+
+static bool isSync(const uint8_t* data)
+{
+    uint32_t sync;
+    memcpy(&sync, data, sizeof(sync));
+    return (sync == 0x49c5f8ff) || (sync == 0xb63a07ff);
+}
+
+
+InputMmapReader::InputMmapReader(Logger logger) :
+    loop_(false),
+    streamtype_(ETI_STREAM_TYPE_NONE),
+    logger_(logger),
+    map_(NULL),
+    length_(0),
+    start_(0),
+    position_(0),
+    nbframes_(0),
+    index_(NULL),
+    lostbytes_(0),
+    consumed_(0),
+    prefetched_(0),
+    loops_(0),
+    running_(false)
+{
+}
+
+
+InputMmapReader::~InputMmapReader()
+{
+    delete index_;
+
+    if (map_ == NULL) {
+        return;
+    }
+    fprintf(stderr, "\nClosing input file...\n");
+    if (lostbytes_ > 0) {
+        fprintf(stderr, "Input lost %lu bytes to resynchronisation\n",
+                lostbytes_);
+    }
+
+    {
+        boost::mutex::scoped_lock lock(readahead_mutex_);
+        running_ = false;
+    }
+    readahead_cond_.notify_one();
+    if (readahead_thread_.joinable()) {
+        readahead_thread_.join();
+    }
+
+    munmap(const_cast<uint8_t*>(map_), length_);
+}
+
+
+int InputMmapReader::Open(std::string filename, bool loop)
+{
+    filename_ = filename;
+    loop_ = loop;
+
+    int fd = open(filename_.c_str(), O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Unable to open input file!\n");
+        logger_.level(error) << "Unable to open input file!";
+        perror(filename_.c_str());
+        return -1;
+    }
+
+    if (fstat(fd, &filestat_) != 0 || !S_ISREG(filestat_.st_mode) ||
+            filestat_.st_size == 0) {
+        fprintf(stderr, "Unable to map input file, it must be a regular, "
+                "non-empty file!\n");
+        logger_.level(error) << "Unable to map input file!";
+        close(fd);
+        return -1;
+    }
+    length_ = filestat_.st_size;
+
+    void* map = mmap(NULL, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Unable to map input file!\n");
+        logger_.level(error) << "Unable to map input file!";
+        perror(filename_.c_str());
+        return -1;
+    }
+    map_ = (const uint8_t*)map;
+    madvise(map, length_, MADV_SEQUENTIAL);
+
+    if (IdentifyType() != 0) {
+        return -1;
+    }
+
+    running_ = true;
+    readahead_thread_ = boost::thread(&InputMmapReader::Readahead, this);
+    return 0;
+}
+
+
+int InputMmapReader::IdentifyType()
+{
+    position_ = 0;
+
+    if (length_ < 4) {
+        fprintf(stderr, "Unable to read sync in input file!\n");
+        logger_.level(error) << "Unable to read sync in input file!";
+        return -1;
+    }
+    if (isSync(map_)) {
+        streamtype_ = ETI_STREAM_TYPE_RAW;
+        start_ = 0;
+        nbframes_ = length_ / 6144;
+        return 0;
+    }
+
+    if (length_ < 6) {
+        fprintf(stderr, "Unable to read frame size in input file!\n");
+        logger_.level(error) << "Unable to read frame size in input file!";
+        return -1;
+    }
+    if (isSync(map_ + 2)) {
+        uint16_t frameSize;
+        memcpy(&frameSize, map_, sizeof(frameSize));
+        streamtype_ = ETI_STREAM_TYPE_STREAMED;
+        start_ = 0;
+        nbframes_ = length_ / (frameSize + 2);
+        return 0;
+    }
+
+    if (length_ < 10) {
+        fprintf(stderr, "Unable to read nb frame in input file!\n");
+        logger_.level(error) << "Unable to read nb frame in input file!";
+        return -1;
+    }
+    if (isSync(map_ + 6)) {
+        uint32_t nbFrames;
+        memcpy(&nbFrames, map_, sizeof(nbFrames));
+        streamtype_ = ETI_STREAM_TYPE_FRAMED;
+        start_ = 4;
+        position_ = start_;
+        nbframes_ = nbFrames;
+        return 0;
+    }
+
+    // Search for the first frame of a raw stream
+    size_t end = std::min(length_, (size_t)6144 + 10);
+    for (size_t offset = 7; offset < end; ++offset) {
+        offset += findEtiSync(map_ + offset, end - offset);
+        if (offset < end &&
+                isEtiFrameStart(map_ + offset, length_ - offset)) {
+            streamtype_ = ETI_STREAM_TYPE_RAW;
+            start_ = offset;
+            position_ = start_;
+            nbframes_ = (length_ - start_) / 6144;
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "Bad input file format!\n");
+    logger_.level(error) << "Bad input file format!";
+    return -1;
+}
+
+
+void InputMmapReader::PrintInfo()
+{
+    fprintf(stderr, "Input file format: ");
+    switch (streamtype_) {
+        case ETI_STREAM_TYPE_RAW:
+            fprintf(stderr, "raw");
+            break;
+        case ETI_STREAM_TYPE_STREAMED:
+            fprintf(stderr, "streamed");
+            break;
+        case ETI_STREAM_TYPE_FRAMED:
+            fprintf(stderr, "framed");
+            break;
+        default:
+            fprintf(stderr, "unknown!");
+            break;
+    }
+    fprintf(stderr, ", memory mapped\n");
+    fprintf(stderr, "Input file length: %zu\n", length_);
+    fprintf(stderr, "Input file nb frames: %lu\n", nbframes_);
+}
+
+
+void InputMmapReader::Resync()
+{
+    size_t offset = position_ + 1;
+    while (offset < length_) {
+        offset += findEtiSync(map_ + offset, length_ - offset);
+        if (offset < length_ &&
+                isEtiFrameStart(map_ + offset, length_ - offset)) {
+            break;
+        }
+        ++offset;
+    }
+    offset = std::min(offset, length_);
+
+    lostbytes_ += offset - position_;
+    fprintf(stderr, "Input lost sync at offset %zu, skipped %zu bytes "
+            "(%lu bytes lost in total)\n",
+            position_, offset - position_, lostbytes_);
+    logger_.level(warn) << "Input lost sync at offset " << position_ <<
+        ", skipped " << offset - position_ << " bytes";
+    position_ = offset;
+}
+
+
+const uint8_t* InputMmapReader::NextFrame(int& frameSize)
+{
+    bool wrapped = false;
+    for (;;) {
+        if (position_ >= length_ && loop_ && length_ > start_ && !wrapped) {
+            position_ = start_;
+            ++loops_;
+            wrapped = true;
+        }
+        if (position_ >= length_) {
+            logger_.level(error) << "Reached end of file.";
+            frameSize = wrapped ? -1 : 0;
+            return NULL;
+        }
+
+        // A raw stream carries no frame boundaries of its own, find the
+        // next valid frame after a corruption
+        if (streamtype_ == ETI_STREAM_TYPE_RAW &&
+                !isEtiFrameStart(map_ + position_, length_ - position_)) {
+            Resync();
+            continue;
+        }
+        break;
+    }
+
+    size_t offset = position_;
+    size_t size = 6144;
+    if (streamtype_ != ETI_STREAM_TYPE_RAW) {
+        uint16_t size16;
+        if (offset + sizeof(size16) > length_) {
+            size = length_;
+        }
+        else {
+            memcpy(&size16, map_ + offset, sizeof(size16));
+            offset += sizeof(size16);
+            size = size16;
+        }
+        if (size > 6144) { // there might be a better limit
+            logger_.level(error) << "Wrong frame size " << size << " in ETI file!";
+            fprintf(stderr, "Wrong frame size %zu in ETI file!\n", size);
+            frameSize = -1;
+            return NULL;
+        }
+    }
+
+    if (offset + size > length_) {
+        // A short read of a frame (i.e. reading an incomplete frame)
+        // is not tolerated. Input files must not contain incomplete frames
+        fprintf(stderr,
+                "Unable to read a complete frame of %zu data bytes from input file!\n",
+                size);
+        logger_.level(error) << "Unable to read from input file!";
+        frameSize = -1;
+        return NULL;
+    }
+    position_ = offset + size;
+    PDEBUG("Frame size: %zu\n", size);
+
+    boost::mutex::scoped_lock lock(readahead_mutex_);
+    consumed_ = loops_ * (length_ - start_) + position_ - start_;
+    if (consumed_ + READAHEAD_WINDOW / 2 > prefetched_) {
+        readahead_cond_.notify_one();
+    }
+
+    frameSize = size;
+    return map_ + offset;
+}
+
+
+int InputMmapReader::GetNextFrame(void* buffer)
+{
+    int frameSize;
+    const uint8_t* frame = NextFrame(frameSize);
+    if (frame == NULL) {
+        return frameSize;
+    }
+
+    memcpy(buffer, frame, frameSize);
+    memset(&((uint8_t*)buffer)[frameSize], 0x55, 6144 - frameSize);
+
+    return 6144;
+}
+
+
+int InputMmapReader::GetNextFrameBuffer(Buffer* buffer)
+{
+    int frameSize;
+    const uint8_t* frame = NextFrame(frameSize);
+    if (frame == NULL) {
+        return frameSize;
+    }
+
+    if (frameSize == 6144) {
+        buffer->setExternalData(frame, frameSize);
+    }
+    else {
+        buffer->setLength(6144);
+        memcpy(buffer->getData(), frame, frameSize);
+        memset(&((uint8_t*)buffer->getData())[frameSize], 0x55,
+                6144 - frameSize);
+    }
+
+    return 6144;
+}
+
+
+int InputMmapReader::UseIndex(bool create)
+{
+    const std::string filename = filename_ + ".idx";
+
+    delete index_;
+    index_ = new EtiIndex();
+    if (index_->load(filename, filestat_, streamtype_)) {
+        fprintf(stderr, "Input file index: %s, %zu frames\n",
+                filename.c_str(), index_->size());
+        return 0;
+    }
+    if (!create) {
+        fprintf(stderr, "No valid input file index %s\n", filename.c_str());
+        delete index_;
+        index_ = NULL;
+        return -1;
+    }
+
+    fprintf(stderr, "Indexing input file...\n");
+    index_->build(map_, filestat_, start_, streamtype_);
+    if (!index_->save(filename)) {
+        // The index can still be used for this run
+        fprintf(stderr, "Unable to write input file index %s\n",
+                filename.c_str());
+    }
+    fprintf(stderr, "Input file index: %s, %zu frames\n",
+            filename.c_str(), index_->size());
+    return 0;
+}
+
+
+int InputMmapReader::Seek(uint64_t frame)
+{
+    size_t offset = start_;
+
+    if (index_ != NULL) {
+        if (frame >= index_->size()) {
+            return -1;
+        }
+        offset = (*index_)[frame].offset;
+    }
+    else if (streamtype_ == ETI_STREAM_TYPE_RAW) {
+        offset = start_ + frame * 6144;
+    }
+    else {
+        // Hop over the frame size fields
+        for (uint64_t i = 0; i < frame && offset + 2 <= length_; ++i) {
+            uint16_t frameSize;
+            memcpy(&frameSize, map_ + offset, sizeof(frameSize));
+            offset += sizeof(frameSize) + frameSize;
+        }
+    }
+    if (offset >= length_) {
+        return -1;
+    }
+
+    position_ = offset;
+    boost::mutex::scoped_lock lock(readahead_mutex_);
+    loops_ = 0;
+    consumed_ = position_ - start_;
+    prefetched_ = consumed_;
+    readahead_cond_.notify_one();
+    return 0;
+}
+
+
+int InputMmapReader::SeekTime(double time)
+{
+    if (index_ == NULL) {
+        // Without index, the frames have to be scanned once anyway
+        index_ = new EtiIndex();
+        index_->build(map_, filestat_, start_, streamtype_);
+    }
+
+    size_t frame = index_->findTime(time);
+    if (frame >= index_->size()) {
+        return -1;
+    }
+    fprintf(stderr, "Starting at frame %zu, FCT %u\n", frame,
+            (unsigned)(*index_)[frame].fct);
+    return Seek(frame);
+}
+
+
+void InputMmapReader::Readahead()
+{
+    const uint64_t dataLength = length_ - start_;
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+
+    boost::mutex::scoped_lock lock(readahead_mutex_);
+    while (running_) {
+        uint64_t from = prefetched_ > consumed_ ? prefetched_ : consumed_;
+        uint64_t to = consumed_ + READAHEAD_WINDOW;
+        if (!loop_ && to > dataLength) {
+            to = dataLength;
+        }
+        if (from >= to) {
+            readahead_cond_.wait(lock);
+            continue;
+        }
+        lock.unlock();
+
+        // Reading one byte per page faults it in, in this thread instead
+        // of the modulator's
+        volatile uint8_t sink = 0;
+        for (uint64_t i = from; i < to; i += pageSize) {
+            sink += map_[start_ + i % dataLength];
+        }
+        (void)sink;
+
+        lock.lock();
+        prefetched_ = to;
+    }
+}
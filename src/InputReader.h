@@ -31,12 +31,17 @@
 #endif
 
 #include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
 #if defined(HAVE_INPUT_ZEROMQ)
 #  include "zmq.hpp"
 #  include "ThreadsafeQueue.h"
 #endif
+#include <boost/thread.hpp>
 #include "porting.h"
 #include "Log.h"
+#include "Buffer.h"
+#include "InputDecompressor.h"
 
 /* Known types of input streams. Description taken from the CRC mmbTools forum.
 
@@ -70,14 +75,26 @@ enum EtiStreamType {
     ETI_STREAM_TYPE_FRAMED,
 };
 
+class EtiIndex;
+
 class InputReader
 {
     public:
+        virtual ~InputReader() {}
+
         // Put next frame into buffer. This function will never write more than
         // 6144 bytes into buffer.
         // returns number of bytes written to buffer, 0 on eof, -1 on error
         virtual int GetNextFrame(void* buffer) = 0;
 
+        // Same as GetNextFrame, but readers that hold the frame in memory
+        // let buffer point to it instead of copying it. The frame then
+        // stays valid until the next call.
+        virtual int GetNextFrameBuffer(Buffer* buffer)
+        {
+            return GetNextFrame(buffer->getData());
+        }
+
         // Print some information
         virtual void PrintInfo() = 0;
 };
@@ -87,15 +104,22 @@ class InputFileReader : public InputReader
     public:
         InputFileReader(Logger logger) :
             streamtype_(ETI_STREAM_TYPE_NONE),
-            inputfile_(NULL), logger_(logger) {};
+            inputfile_(NULL), logger_(logger), lostbytes_(0),
+            compression_(COMPRESSION_NONE), pipebuffer_(NULL),
+            pipebuffersize_(0) {};
 
         ~InputFileReader()
         {
             fprintf(stderr, "\nClosing input file...\n");
+            if (lostbytes_ > 0) {
+                fprintf(stderr, "Input lost %lu bytes to resynchronisation\n",
+                        lostbytes_);
+            }
 
             if (inputfile_ != NULL) {
                 fclose(inputfile_);
             }
+            free(pipebuffer_);
         }
 
         // open file and determine stream type
@@ -112,6 +136,12 @@ class InputFileReader : public InputReader
             return streamtype_;
         }
 
+        // Bytes skipped to find the next frame after a corruption
+        uint64_t GetLostBytes()
+        {
+            return lostbytes_;
+        }
+
     private:
         int IdentifyType();
 
@@ -119,20 +149,156 @@ class InputFileReader : public InputReader
         // returns 0 on success, -1 on failure
         int Rewind();
 
+        // Shifts the raw frame in buffer to the next valid frame,
+        // reading the missing bytes
+        // returns 1 on success, 0 on eof, -1 on error
+        int Resync(uint8_t* buffer);
+
         bool loop_; // if shall we loop the file over and over
         std::string filename_;
         EtiStreamType streamtype_;
         FILE* inputfile_;
         Logger logger_;
+        uint64_t lostbytes_;
+        CompressionType compression_;
+
+        // Page aligned stdio buffer as large as the pipe, to read all the
+        // frames written in a burst at once
+        char* pipebuffer_;
+        size_t pipebuffersize_;
 
         size_t inputfilelength_;
         uint64_t nbframes_; // 64-bit because 32-bit overflow is
                             // after 2**32 * 24ms ~= 3.3 years
 };
 
+/* Reads an ETI file through a memory mapping. Raw frames are handed out
+ * in place, the other formats are padded to 6144 bytes in the caller's
+ * buffer. Looping wraps back to the first frame, and a thread faults in
+ * the pages ahead of the current frame, so that a cold page cache does not
+ * stall the modulator. Only regular files can be mapped.
+ */
+class InputMmapReader : public InputReader
+{
+    public:
+        InputMmapReader(Logger logger);
+        ~InputMmapReader();
+
+        // map file and determine stream type
+        // When loop=1, GetNextFrame will never return 0
+        int Open(std::string filename, bool loop);
+
+        // Print information about the file opened
+        void PrintInfo();
+
+        int GetNextFrame(void* buffer);
+        int GetNextFrameBuffer(Buffer* buffer);
+
+        EtiStreamType GetStreamType()
+        {
+            return streamtype_;
+        }
+
+        // Loads the index kept next to the file (filename.idx). When it is
+        // missing or stale and create is set, the file is indexed and the
+        // index written.
+        // returns 0 on success, -1 on failure
+        int UseIndex(bool create);
+
+        // Continue with the given frame, or with the first frame at or
+        // after the given time (seconds since the epoch, UTC). Without an
+        // index, the frames are scanned from the start of the file.
+        // returns 0 on success, -1 if there is no such frame
+        int Seek(uint64_t frame);
+        int SeekTime(double time);
+
+        // Bytes skipped to find the next frame after a corruption
+        uint64_t GetLostBytes()
+        {
+            return lostbytes_;
+        }
+
+    private:
+        InputMmapReader(const InputMmapReader& other);
+        InputMmapReader& operator=(const InputMmapReader& other);
+
+        int IdentifyType();
+
+        // Returns the next frame inside the mapping and sets frameSize,
+        // or returns NULL and sets frameSize to 0 on eof, -1 on error
+        const uint8_t* NextFrame(int& frameSize);
+
+        // Moves to the next valid frame of a raw stream
+        void Resync();
+
+        void Readahead();
+
+        bool loop_;
+        std::string filename_;
+        EtiStreamType streamtype_;
+        Logger logger_;
+
+        const uint8_t* map_;
+        struct stat filestat_;
+        size_t length_;
+        size_t start_; // offset of the first frame
+        size_t position_; // offset of the next frame
+        uint64_t nbframes_;
+        EtiIndex* index_;
+        uint64_t lostbytes_;
+
+        // Bytes handed out and bytes faulted in since the file was opened,
+        // counting every loop, protected by readahead_mutex_
+        uint64_t consumed_;
+        uint64_t prefetched_;
+        uint64_t loops_;
+        bool running_;
+        boost::mutex readahead_mutex_;
+        boost::condition_variable readahead_cond_;
+        boost::thread readahead_thread_;
+};
+
+/* Receives split frames from a central coding instance over TCP, see
+ * SplitFrame.h and OutputTcp.h. The frames are at most
+ * SPLIT_FRAME_MAX_SIZE bytes long, which is more than an ETI frame.
+ */
+class InputTcpReader : public InputReader
+{
+    public:
+        InputTcpReader(Logger logger) :
+            sock_(-1), logger_(logger) {}
+
+        ~InputTcpReader();
+
+        // Connect to host:port
+        int Open(std::string address);
+
+        int GetNextFrame(void* buffer);
+
+        void PrintInfo();
+
+    private:
+        InputTcpReader(const InputTcpReader& other);
+        std::string address_;
+        int sock_;
+        Logger logger_;
+};
+
 #if defined(HAVE_INPUT_ZEROMQ)
 /* A ZeroMQ input. See www.zeromq.org for more info */
 
+/* A message carries either a single ETI frame, or several frames after
+ * this header. The frames follow the header back to back without their
+ * padding, unused slots have a length of -1. A single frame starts with
+ * its sync word and cannot be mistaken for the version. */
+#define NUM_FRAMES_PER_ZMQ_MESSAGE 4
+
+struct zmq_dab_message_header
+{
+    uint32_t version; // 1
+    int16_t buflen[NUM_FRAMES_PER_ZMQ_MESSAGE];
+};
+
 struct InputZeroMQThreadData
 {
     ThreadsafeQueue<zmq::message_t*> *in_messages;
@@ -158,7 +324,8 @@ class InputZeroMQReader : public InputReader
 {
     public:
         InputZeroMQReader(Logger logger) :
-            logger_(logger), in_messages_(10)
+            logger_(logger), in_messages_(10),
+            message_(NULL), numframes_(0), nextframe_(0)
         {
             workerdata_.in_messages = &in_messages_;
         }
@@ -166,22 +333,36 @@ class InputZeroMQReader : public InputReader
         ~InputZeroMQReader()
         {
             worker_.Stop();
+            delete message_;
         }
 
         int Open(std::string uri);
 
         int GetNextFrame(void* buffer);
+        int GetNextFrameBuffer(Buffer* buffer);
 
         void PrintInfo();
 
     private:
         InputZeroMQReader(const InputZeroMQReader& other) {}
+
+        // Return the next frame inside the current message, which is kept
+        // until the following call
+        const uint8_t* NextFrame(int& frameSize);
+        int SplitMessage();
+
         Logger logger_;
         std::string uri_;
 
         InputZeroMQWorker worker_;
         ThreadsafeQueue<zmq::message_t*> in_messages_;
         struct InputZeroMQThreadData workerdata_;
+
+        zmq::message_t* message_;
+        const uint8_t* frames_[NUM_FRAMES_PER_ZMQ_MESSAGE];
+        size_t framesizes_[NUM_FRAMES_PER_ZMQ_MESSAGE];
+        size_t numframes_;
+        size_t nextframe_;
 };
 
 #endif
@@ -0,0 +1,148 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include "InputReader.h"
+#include "SplitFrame.h"
+#include "PcDebug.h"
+
+
+InputTcpReader::~InputTcpReader()
+{
+    if (sock_ != -1) {
+        close(sock_);
+    }
+}
+
+
+int InputTcpReader::Open(std::string address)
+{
+    address_ = address;
+
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        logger_.level(error) << "TCP input address " << address <<
+            " must be host:port";
+        return -1;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+
+    struct addrinfo hints;
+    struct addrinfo* res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    int ret = getaddrinfo(host.c_str(), port.c_str(), &hints, &res);
+    if (ret != 0) {
+        logger_.level(error) << "Unable to resolve " << address << ": " <<
+            gai_strerror(ret);
+        return -1;
+    }
+
+    for (struct addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+        sock_ = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (sock_ == -1) {
+            continue;
+        }
+        if (connect(sock_, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(sock_);
+        sock_ = -1;
+    }
+    freeaddrinfo(res);
+
+    if (sock_ == -1) {
+        logger_.level(error) << "Unable to connect to " << address;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// Read exactly length bytes, returns 0 on end of stream and -1 on error
+static int recvAll(int sock, void* buffer, size_t length)
+{
+    char* buf = reinterpret_cast<char*>(buffer);
+    while (length > 0) {
+        ssize_t received = recv(sock, buf, length, 0);
+        if (received == 0) {
+            return 0;
+        }
+        if (received == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("InputTcpReader");
+            return -1;
+        }
+        buf += received;
+        length -= received;
+    }
+    return 1;
+}
+
+
+int InputTcpReader::GetNextFrame(void* buffer)
+{
+    uint32_t length;
+
+    int ret = recvAll(sock_, &length, sizeof(length));
+    if (ret <= 0) {
+        return ret;
+    }
+
+    length = ntohl(length);
+    if (length > SPLIT_FRAME_MAX_SIZE) {
+        logger_.level(error) << "Received frame of " << length <<
+            " bytes, more than the largest split frame";
+        return -1;
+    }
+
+    ret = recvAll(sock_, buffer, length);
+    if (ret <= 0) {
+        return ret;
+    }
+
+    return length;
+}
+
+
+void InputTcpReader::PrintInfo()
+{
+    fprintf(stderr, "Input TCP address: %s\n", address_.c_str());
+}
@@ -37,6 +37,7 @@
 #include <boost/thread/thread.hpp>
 #include "porting.h"
 #include "InputReader.h"
+#include "Eti.h"
 #include "PcDebug.h"
 
 #define MAX_QUEUE_SIZE 50
@@ -53,29 +54,120 @@ int InputZeroMQReader::Open(std::string uri)
 
 int InputZeroMQReader::GetNextFrame(void* buffer)
 {
-    zmq::message_t* incoming;
-    in_messages_.wait_and_pop(incoming);
+    int frameSize;
+    const uint8_t* frame = NextFrame(frameSize);
+    if (frame == NULL) {
+        return frameSize;
+    }
 
-    size_t framesize = incoming->size();
+    memcpy(buffer, frame, frameSize);
 
-    // guarantee that we never will write more than 6144 bytes
-    if (framesize > 6144) {
-        fprintf(stderr, "ZeroMQ message too large: %zu!\n", framesize);
-        logger_.level(error) << "ZeroMQ message too large" << framesize;
-        return -1;
-    }
+    // pad to 6144 bytes
+    memset(&((uint8_t*)buffer)[frameSize], 0x55, 6144 - frameSize);
 
-    memcpy(buffer, incoming->data(), framesize);
+    return 6144;
+}
 
-    delete incoming;
+int InputZeroMQReader::GetNextFrameBuffer(Buffer* buffer)
+{
+    // Detach the buffer from the previous message before it is released
+    buffer->setLength(0);
 
-    // pad to 6144 bytes
-    memset(&((uint8_t*)buffer)[framesize], 0x55, 6144 - framesize);
+    int frameSize;
+    const uint8_t* frame = NextFrame(frameSize);
+    if (frame == NULL) {
+        return frameSize;
+    }
 
+    // The EtiReader does not need the padding of a complete frame, anything
+    // else goes through the state machine and must be padded
+    if (isEtiFrameStart(frame, frameSize)) {
+        eti_FC fc;
+        memcpy(&fc, frame + 4, sizeof(fc));
+        if (8 + 4 * (size_t)fc.getFrameLength() + 8 <= (size_t)frameSize) {
+            buffer->setExternalData(frame, frameSize);
+            return frameSize;
+        }
+    }
+
+    buffer->setLength(6144);
+    memcpy(buffer->getData(), frame, frameSize);
+    memset(&((uint8_t*)buffer->getData())[frameSize], 0x55, 6144 - frameSize);
 
     return 6144;
 }
 
+const uint8_t* InputZeroMQReader::NextFrame(int& frameSize)
+{
+    while (nextframe_ == numframes_) {
+        delete message_;
+        message_ = NULL;
+
+        in_messages_.wait_and_pop(message_);
+
+        if (SplitMessage() == -1) {
+            frameSize = -1;
+            return NULL;
+        }
+    }
+
+    frameSize = framesizes_[nextframe_];
+    return frames_[nextframe_++];
+}
+
+int InputZeroMQReader::SplitMessage()
+{
+    const uint8_t* data = (const uint8_t*)message_->data();
+    size_t size = message_->size();
+
+    numframes_ = 0;
+    nextframe_ = 0;
+
+    struct zmq_dab_message_header header;
+    if (size >= sizeof(header)) {
+        memcpy(&header, data, sizeof(header));
+    }
+
+    if (size < sizeof(header) || header.version != 1) {
+        // guarantee that we never will write more than 6144 bytes
+        if (size > 6144) {
+            fprintf(stderr, "ZeroMQ message too large: %zu!\n", size);
+            logger_.level(error) << "ZeroMQ message too large" << size;
+            return -1;
+        }
+
+        if (size > 0) {
+            frames_[0] = data;
+            framesizes_[0] = size;
+            numframes_ = 1;
+        }
+        return 0;
+    }
+
+    size_t offset = sizeof(header);
+    for (int i = 0; i < NUM_FRAMES_PER_ZMQ_MESSAGE; i++) {
+        if (header.buflen[i] <= 0) {
+            continue;
+        }
+
+        size_t framesize = header.buflen[i];
+        if (framesize > 6144 || offset + framesize > size) {
+            fprintf(stderr, "ZeroMQ message frame %d invalid: %zu bytes!\n",
+                    i, framesize);
+            logger_.level(error) << "ZeroMQ message frame " << i <<
+                " invalid: " << framesize << " bytes";
+            return -1;
+        }
+
+        frames_[numframes_] = data + offset;
+        framesizes_[numframes_] = framesize;
+        numframes_++;
+        offset += framesize;
+    }
+
+    return 0;
+}
+
 void InputZeroMQReader::PrintInfo()
 {
     fprintf(stderr, "Input ZeroMQ:\n");
@@ -48,6 +48,10 @@ public:
     virtual int process(std::vector<Buffer*> dataIn,
             std::vector<Buffer*> dataOut) = 0;
     virtual const char* name() = 0;
+    // True if the output is the same on every frame as long as the
+    // inputs are. The flowgraph runs such plugins only once when all
+    // their inputs are constant.
+    virtual bool isConstant() { return false; }
     
 protected:
     ModFormat myInputFormat;
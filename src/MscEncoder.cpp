@@ -0,0 +1,155 @@
+/*
+   Copyright (C) 2007, 2008, 2009, 2010, 2011, 2012
+   Her Majesty the Queen in Right of Canada (Communications Research
+   Center Canada)
+
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MscEncoder.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <stdexcept>
+#include <assert.h>
+#include <string.h>
+
+
+MscEncoder::MscEncoder(size_t framesize,
+        const std::vector<SubchannelSource*>& subchannels) :
+    ModMux(ModFormat(framesize), ModFormat(framesize)),
+    d_frameSize(framesize),
+    d_prbs(NULL),
+    d_interleaver(NULL)
+{
+    PDEBUG("MscEncoder::MscEncoder(%zu) @ %p\n", framesize, this);
+
+    size_t maxInputSize = 0;
+    size_t codedSize = 0;
+    std::vector<SubchannelSource*>::const_iterator subchannel;
+    for (subchannel = subchannels.begin();
+            subchannel != subchannels.end();
+            ++subchannel) {
+        MscSegment segment;
+        segment.inputSize = (*subchannel)->framesize();
+        segment.codedOffset = codedSize;
+        segment.codedSize = (*subchannel)->framesizeCu() * 8;
+        segment.cifOffset = (*subchannel)->startAddress() * 8;
+
+        segment.encoder = new PuncturedConvEncoder();
+        const std::vector<PuncturingRule*>& rules = (*subchannel)->get_rules();
+        std::vector<PuncturingRule*>::const_iterator rule;
+        for (rule = rules.begin(); rule != rules.end(); ++rule) {
+            segment.encoder->append_rule(*(*rule));
+        }
+        segment.encoder->append_tail_rule(PuncturingRule(3, 0xcccccc));
+
+        if (segment.encoder->getInputSize() != segment.inputSize ||
+                segment.encoder->getOutputSize() != segment.codedSize) {
+            delete segment.encoder;
+            throw std::runtime_error(
+                    "MscEncoder::MscEncoder puncturing rules do not match "
+                    "subchannel size!");
+        }
+        if (segment.cifOffset + segment.codedSize > framesize) {
+            delete segment.encoder;
+            throw std::runtime_error(
+                    "MscEncoder::MscEncoder subchannel out of CIF!");
+        }
+
+        PDEBUG(" Segment: %zu -> %zu bytes at %zu\n", segment.inputSize,
+                segment.codedSize, segment.cifOffset);
+        d_segments.push_back(segment);
+
+        if (segment.inputSize > maxInputSize) {
+            maxInputSize = segment.inputSize;
+        }
+        codedSize += segment.codedSize;
+    }
+
+    // The energy dispersal sequence restarts for each subchannel and
+    // each frame, the generator only computes it once
+    d_prbs = new PrbsGenerator(maxInputSize, 0x110);
+    d_scrambled.setLength(maxInputSize);
+    d_coded.setLength(codedSize);
+    d_interleaver = new TimeInterleaver(codedSize);
+}
+
+
+MscEncoder::~MscEncoder()
+{
+    PDEBUG("MscEncoder::~MscEncoder() @ %p\n", this);
+
+    std::vector<MscSegment>::iterator segment;
+    for (segment = d_segments.begin(); segment != d_segments.end(); ++segment) {
+        delete segment->encoder;
+    }
+    delete d_prbs;
+    delete d_interleaver;
+}
+
+
+// dataIn[0] -> PRBS
+// dataIn[1+] -> subchannels
+int MscEncoder::process(std::vector<Buffer*> dataIn, Buffer* dataOut)
+{
+    PDEBUG("MscEncoder::process(dataIn: %zu buffers, dataOut: %p)\n",
+            dataIn.size(), dataOut);
+
+    assert(dataIn.size() == d_segments.size() + 1);
+    assert(dataIn[0]->getLength() == d_frameSize);
+    dataOut->setLength(d_frameSize);
+
+    unsigned char* scrambled =
+        reinterpret_cast<unsigned char*>(d_scrambled.getData());
+    unsigned char* coded =
+        reinterpret_cast<unsigned char*>(d_coded.getData());
+
+    // Energy dispersal and encoding, segments are packed in d_coded
+    for (size_t i = 0; i < d_segments.size(); ++i) {
+        const MscSegment& segment = d_segments[i];
+        if (dataIn[i + 1]->getLength() != segment.inputSize) {
+            throw std::runtime_error(
+                    "MscEncoder::process wrong subchannel size!");
+        }
+        const unsigned char* in =
+            reinterpret_cast<const unsigned char*>(dataIn[i + 1]->getData());
+
+        d_prbs->mix(in, scrambled, segment.inputSize);
+        segment.encoder->encode(scrambled, &coded[segment.codedOffset]);
+    }
+
+    // Subchannel sizes are multiples of 8 bytes, so the whole packed MSC
+    // goes through a single interleaver
+    d_interleaver->process(&d_coded, &d_interleaved);
+
+    // Padding, then subchannels at their start address
+    unsigned char* out = reinterpret_cast<unsigned char*>(dataOut->getData());
+    const unsigned char* interleaved =
+        reinterpret_cast<const unsigned char*>(d_interleaved.getData());
+    memcpy(out, dataIn[0]->getData(), d_frameSize);
+    for (size_t i = 0; i < d_segments.size(); ++i) {
+        const MscSegment& segment = d_segments[i];
+        memcpy(&out[segment.cifOffset], &interleaved[segment.codedOffset],
+                segment.codedSize);
+    }
+
+    return dataOut->getLength();
+}
@@ -0,0 +1,81 @@
+/*
+   Copyright (C) 2007, 2008, 2009, 2010, 2011, 2012
+   Her Majesty the Queen in Right of Canada (Communications Research
+   Center Canada)
+
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MSC_ENCODER_H
+#define MSC_ENCODER_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModMux.h"
+#include "SubchannelSource.h"
+#include "PuncturedConvEncoder.h"
+#include "TimeInterleaver.h"
+#include "PrbsGenerator.h"
+
+
+#include <sys/types.h>
+#include <vector>
+
+
+// Position of one subchannel in the input, coded and CIF buffers
+struct MscSegment {
+    size_t inputSize;
+    size_t codedOffset;
+    size_t codedSize;
+    size_t cifOffset;
+    PuncturedConvEncoder* encoder;
+};
+
+
+// Channel coding of the whole MSC: energy dispersal, convolutional
+// encoding, puncturing and time interleaving of all subchannels, which
+// are then placed in the CIF.
+class MscEncoder : public ModMux
+{
+public:
+    MscEncoder(size_t frameSize, const std::vector<SubchannelSource*>& subchannels);
+    virtual ~MscEncoder();
+    MscEncoder(const MscEncoder&);
+    MscEncoder& operator=(const MscEncoder&);
+
+
+    int process(std::vector<Buffer*> dataIn, Buffer* dataOut);
+    const char* name() { return "MscEncoder"; }
+
+protected:
+    size_t d_frameSize;
+    std::vector<MscSegment> d_segments;
+    PrbsGenerator* d_prbs;
+    Buffer d_scrambled;
+    Buffer d_coded;
+    Buffer d_interleaved;
+    TimeInterleaver* d_interleaver;
+};
+
+
+#endif // MSC_ENCODER_H
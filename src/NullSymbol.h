@@ -44,6 +44,7 @@ public:
 
     int process(Buffer* const dataIn, Buffer* dataOut);
     const char* name() { return "NullSymbol"; }
+    bool isConstant() { return true; }
 };
 
 
@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Numa.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+
+static const char* NODE_PATH = "/sys/devices/system/node";
+
+
+std::vector<int> parseCpuList(const std::string& cpus)
+{
+    std::vector<int> list;
+    std::stringstream ss(cpus);
+    std::string range;
+
+    while (std::getline(ss, range, ',')) {
+        // sysfs lists end with a newline
+        range.erase(range.find_last_not_of(" \n") + 1);
+        if (range.empty()) {
+            continue;
+        }
+        char* end;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || end == range.c_str() || first < 0 ||
+                last < first || last >= CPU_SETSIZE) {
+            throw std::runtime_error("parseCpuList invalid CPU list '" +
+                    cpus + "'!");
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            list.push_back(cpu);
+        }
+    }
+    return list;
+}
+
+
+int numaNodeCount()
+{
+    int count = 0;
+    for (;;) {
+        std::stringstream path;
+        path << NODE_PATH << "/node" << count;
+        if (access(path.str().c_str(), F_OK) != 0) {
+            break;
+        }
+        ++count;
+    }
+    return count > 0 ? count : 1;
+}
+
+
+std::vector<int> numaNodeCpus(int node)
+{
+    std::stringstream path;
+    path << NODE_PATH << "/node" << node << "/cpulist";
+
+    std::ifstream file(path.str().c_str());
+    std::string cpus;
+    if (!file || !std::getline(file, cpus)) {
+        return std::vector<int>();
+    }
+    return parseCpuList(cpus);
+}
+
+
+int numaDeviceNode(const std::string& device)
+{
+    std::string path = device;
+    if (device.find('/') == std::string::npos) {
+        path = "/sys/class/net/" + device + "/device";
+    }
+
+    char resolved[PATH_MAX];
+    if (realpath(path.c_str(), resolved) == NULL) {
+        return -1;
+    }
+
+    // USB devices have no node of their own, the one of their host
+    // controller is further up the tree
+    std::string dir = resolved;
+    while (dir.size() > 1) {
+        std::ifstream file((dir + "/numa_node").c_str());
+        int node;
+        if (file >> node) {
+            return node;
+        }
+        dir.erase(dir.find_last_of('/'));
+    }
+    return -1;
+}
+
+
+// Highest node number supported by the memory policy mask
+static const int MAX_NODES = 1024;
+static const size_t BITS_PER_LONG = 8 * sizeof(unsigned long);
+
+
+bool numaBindThread(int node)
+{
+    if (node < 0 || node >= MAX_NODES) {
+        fprintf(stderr, "Warning: invalid NUMA node %d\n", node);
+        return false;
+    }
+
+    std::vector<int> cpus = numaNodeCpus(node);
+    if (cpus.empty()) {
+        fprintf(stderr, "Warning: NUMA node %d has no CPUs\n", node);
+        return false;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        CPU_SET(cpus[i], &cpuset);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (ret != 0) {
+        fprintf(stderr, "Warning: unable to pin thread to NUMA node %d: %s\n",
+                node, strerror(ret));
+        return false;
+    }
+
+    // Buffers are allocated and first touched by the threads that use
+    // them, preferring the node is enough to keep them local
+    unsigned long nodemask[MAX_NODES / BITS_PER_LONG] = {0};
+    nodemask[node / BITS_PER_LONG] |= 1UL << (node % BITS_PER_LONG);
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodemask,
+                MAX_NODES + 1) != 0) {
+        perror("Warning: unable to set NUMA memory policy");
+        return false;
+    }
+
+    PDEBUG("numaBindThread(%d): %zu CPUs\n", node, cpus.size());
+    return true;
+}
+
+
+int numaCurrentNode()
+{
+    unsigned cpu;
+    unsigned node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) {
+        return -1;
+    }
+    return node;
+}
+
+
+int numaAddressNode(const void* address)
+{
+    int node;
+    if (syscall(SYS_get_mempolicy, &node, NULL, 0, address,
+                MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+        return -1;
+    }
+    return node;
+}
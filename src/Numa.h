@@ -0,0 +1,64 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include <string>
+#include <vector>
+
+
+/* Placement of threads and memory on the NUMA nodes of the host, through
+ * the Linux system calls and sysfs, so that no NUMA library is needed.
+ * On hosts with a single node, all of these are harmless.
+ */
+
+// Parses a list of CPUs like "2,3" or "4-7", as used in sysfs
+std::vector<int> parseCpuList(const std::string& cpus);
+
+// Number of NUMA nodes, 1 if the host is not NUMA
+int numaNodeCount();
+
+// CPUs of the given node
+std::vector<int> numaNodeCpus(int node);
+
+// Node of a device, given as a network interface name (e.g. eth0) or a
+// sysfs device path (e.g. /sys/bus/usb/devices/2-1), -1 if unknown
+int numaDeviceNode(const std::string& device);
+
+// Pins the calling thread to the CPUs of the node and makes it prefer the
+// memory of the node. Threads created afterwards by this thread inherit
+// both. Returns false if the node could not be used.
+bool numaBindThread(int node);
+
+// Node the calling thread is currently running on
+int numaCurrentNode();
+
+// Node holding the page at the given address, -1 if unknown
+int numaAddressNode(const void* address);
+
+
+#endif // NUMA_H
@@ -26,29 +26,72 @@
 #include <stdio.h>
 #include <stdexcept>
 #include <assert.h>
+#include <string.h>
 #include <complex>
+#include <map>
+#include <boost/thread/mutex.hpp>
 typedef std::complex<float> complexf;
 
 
+// A plan only holds the twiddle factors and is not modified by kiss_fft,
+// so the generators of all modulators in the process share one plan per
+// FFT size.
+struct SharedFftPlan {
+    FFT_PLAN plan;
+    size_t users;
+};
+static std::map<size_t, SharedFftPlan> sharedFftPlans;
+static boost::mutex sharedFftPlansMutex;
+
+
+static FFT_PLAN acquireFftPlan(size_t size)
+{
+    boost::mutex::scoped_lock lock(sharedFftPlansMutex);
+    SharedFftPlan& shared = sharedFftPlans[size];
+    if (shared.users++ == 0) {
+        shared.plan = kiss_fft_alloc(size, 1, NULL, NULL);
+    }
+    return shared.plan;
+}
+
+
+static void releaseFftPlan(size_t size)
+{
+    boost::mutex::scoped_lock lock(sharedFftPlansMutex);
+    std::map<size_t, SharedFftPlan>::iterator it = sharedFftPlans.find(size);
+    if (it != sharedFftPlans.end() && --it->second.users == 0) {
+        kiss_fft_free(it->second.plan);
+        sharedFftPlans.erase(it);
+    }
+}
+
+
 OfdmGenerator::OfdmGenerator(size_t nbSymbols,
         size_t nbCarriers,
         size_t spacing,
-        bool inverse) :
+        bool inverse,
+        size_t nbConstantSymbols) :
     ModCodec(ModFormat(nbSymbols * nbCarriers * sizeof(FFT_TYPE)),
             ModFormat(nbSymbols * spacing * sizeof(FFT_TYPE))),
     myFftPlan(NULL),
     myFftBuffer(NULL),
     myNbSymbols(nbSymbols),
     myNbCarriers(nbCarriers),
-    mySpacing(spacing)
+    mySpacing(spacing),
+    myNbConstantSymbols(nbConstantSymbols)
 {
-    PDEBUG("OfdmGenerator::OfdmGenerator(%zu, %zu, %zu, %s) @ %p\n",
-            nbSymbols, nbCarriers, spacing, inverse ? "true" : "false", this);
+    PDEBUG("OfdmGenerator::OfdmGenerator(%zu, %zu, %zu, %s, %zu) @ %p\n",
+            nbSymbols, nbCarriers, spacing, inverse ? "true" : "false",
+            nbConstantSymbols, this);
 
     if (nbCarriers > spacing) {
         throw std::runtime_error(
                 "OfdmGenerator::OfdmGenerator nbCarriers > spacing!");
     }
+    if (nbConstantSymbols > nbSymbols) {
+        throw std::runtime_error(
+                "OfdmGenerator::OfdmGenerator nbConstantSymbols > nbSymbols!");
+    }
 
     if (inverse) {
         myPosDst = (nbCarriers & 1 ? 0 : 1);
@@ -77,7 +120,7 @@ OfdmGenerator::OfdmGenerator(size_t nbSymbols,
     PDEBUG("  myZeroDst: %u\n", myZeroDst);
     PDEBUG("  myZeroSize: %u\n", myZeroSize);
 
-    myFftPlan = kiss_fft_alloc(mySpacing, 1, NULL, NULL);
+    myFftPlan = acquireFftPlan(mySpacing);
     myFftBuffer = (FFT_TYPE*)memalign(16, mySpacing * sizeof(FFT_TYPE));
 }
 
@@ -87,7 +130,7 @@ OfdmGenerator::~OfdmGenerator()
     PDEBUG("OfdmGenerator::~OfdmGenerator() @ %p\n", this);
 
     if (myFftPlan != NULL) {
-        kiss_fft_free(myFftPlan);
+        releaseFftPlan(mySpacing);
     }
     if (myFftBuffer != NULL) {
         free(myFftBuffer);
@@ -125,8 +168,16 @@ int OfdmGenerator::process(Buffer* const dataIn, Buffer* dataOut)
                 "OfdmGenerator::process output size not valid!");
     }
 
+    // Reuse the transform of the constant symbols once it is known
+    size_t first = 0;
+    if (myConstantSymbols.getLength()) {
+        first = myNbConstantSymbols;
+        memcpy(out, myConstantSymbols.getData(),
+                myConstantSymbols.getLength());
+    }
+
 #ifdef USE_SIMD
-    for (size_t i = 0, j = 0; i < sizeIn; ) {
+    for (size_t i = first * myNbCarriers, j = first * mySpacing; i < sizeIn; ) {
         // Pack 4 fft operations
         typedef struct {
             float r[4];
@@ -175,7 +226,9 @@ int OfdmGenerator::process(Buffer* const dataIn, Buffer* dataOut)
         }
     }
 #else
-    for (size_t i = 0; i < myNbSymbols; ++i) {
+    in += first * myNbCarriers;
+    out += first * mySpacing;
+    for (size_t i = first; i < myNbSymbols; ++i) {
         FFT_REAL(myFftBuffer[0]) = 0;
         FFT_IMAG(myFftBuffer[0]) = 0;
         bzero(&myFftBuffer[myZeroDst], myZeroSize * sizeof(FFT_TYPE));
@@ -191,5 +244,10 @@ int OfdmGenerator::process(Buffer* const dataIn, Buffer* dataOut)
     }
 #endif
 
+    if (first == 0 && myNbConstantSymbols) {
+        myConstantSymbols.setData(dataOut->getData(),
+                myNbConstantSymbols * mySpacing * sizeof(complexf));
+    }
+
     return sizeOut;
 }
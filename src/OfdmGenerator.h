@@ -38,7 +38,10 @@
 class OfdmGenerator : public ModCodec
 {
 public:
-    OfdmGenerator(size_t nbSymbols, size_t nbCarriers, size_t spacing, bool inverse = true);
+    // The first nbConstantSymbols symbols are the same in every frame
+    // and only transformed once
+    OfdmGenerator(size_t nbSymbols, size_t nbCarriers, size_t spacing,
+            bool inverse = true, size_t nbConstantSymbols = 0);
     virtual ~OfdmGenerator();
     OfdmGenerator(const OfdmGenerator&);
     OfdmGenerator& operator=(const OfdmGenerator&);
@@ -61,6 +64,8 @@ protected:
     unsigned myNegSize;
     unsigned myZeroDst;
     unsigned myZeroSize;
+    size_t myNbConstantSymbols;
+    Buffer myConstantSymbols;
 };
 
 
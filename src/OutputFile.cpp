@@ -20,6 +20,7 @@
  */
 
 #include "OutputFile.h"
+#include "Pipe.h"
 #include "PcDebug.h"
 
 #include <string>
@@ -40,6 +41,12 @@ OutputFile::OutputFile(std::string filename) :
         throw std::runtime_error(
                 "OutputFile::OutputFile() unable to open file!");
     }
+
+    // The reader of a pipe can then take the data in larger bursts without
+    // blocking the modulator
+    if (isPipe(fileno(myFile))) {
+        setPipeSize(fileno(myFile), PIPE_BUFFER_SIZE);
+    }
 }
 
 
@@ -0,0 +1,228 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OutputTcp.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdexcept>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+
+OutputTcp::OutputTcp(unsigned port) :
+    ModOutput(ModFormat(1), ModFormat(0))
+{
+    PDEBUG("OutputTcp::OutputTcp(port: %u) @ %p\n", port, this);
+
+    myListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (myListenSocket == -1) {
+        perror("OutputTcp");
+        throw std::runtime_error("OutputTcp::OutputTcp unable to "
+                "create socket!");
+    }
+
+    int reuse = 1;
+    setsockopt(myListenSocket, SOL_SOCKET, SO_REUSEADDR,
+            &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(myListenSocket, (struct sockaddr*)&addr, sizeof(addr)) == -1 ||
+            listen(myListenSocket, 4) == -1) {
+        perror("OutputTcp");
+        close(myListenSocket);
+        throw std::runtime_error("OutputTcp::OutputTcp unable to "
+                "listen on port!");
+    }
+
+    fcntl(myListenSocket, F_SETFL,
+            fcntl(myListenSocket, F_GETFL) | O_NONBLOCK);
+}
+
+
+OutputTcp::~OutputTcp()
+{
+    PDEBUG("OutputTcp::~OutputTcp() @ %p\n", this);
+
+    for (size_t i = 0; i < myClients.size(); ++i) {
+        close(myClients[i].sock);
+    }
+    close(myListenSocket);
+}
+
+
+void OutputTcp::acceptClients(bool wait)
+{
+    if (wait) {
+        fprintf(stderr, "OutputTcp: waiting for a client...\n");
+        fcntl(myListenSocket, F_SETFL,
+                fcntl(myListenSocket, F_GETFL) & ~O_NONBLOCK);
+    }
+
+    while (true) {
+        struct sockaddr_in addr;
+        socklen_t addrlen = sizeof(addr);
+        int client = accept(myListenSocket, (struct sockaddr*)&addr, &addrlen);
+        if (client == -1) {
+            if (errno == EINTR && wait) {
+                throw std::runtime_error("OutputTcp: interrupted while "
+                        "waiting for a client");
+            }
+            break;
+        }
+
+        fprintf(stderr, "OutputTcp: client %s:%u connected\n",
+                inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+        fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK);
+
+        OutputTcpClient c;
+        c.sock = client;
+        c.offset = 0;
+        myClients.push_back(c);
+
+        if (wait) {
+            fcntl(myListenSocket, F_SETFL,
+                    fcntl(myListenSocket, F_GETFL) | O_NONBLOCK);
+            wait = false;
+        }
+    }
+}
+
+
+bool OutputTcp::sendQueued(OutputTcpClient& client)
+{
+    while (!client.frames.empty()) {
+        Buffer* frame = client.frames.front().get();
+        const char* buf = reinterpret_cast<const char*>(frame->getData());
+        ssize_t sent = send(client.sock, buf + client.offset,
+                frame->getLength() - client.offset, MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.offset += sent;
+        if (client.offset == frame->getLength()) {
+            client.frames.pop_front();
+            client.offset = 0;
+        }
+    }
+    return true;
+}
+
+
+void OutputTcp::waitClients()
+{
+    // A new client is also a client that can receive
+    std::vector<struct pollfd> fds(myClients.size() + 1);
+    for (size_t i = 0; i < myClients.size(); ++i) {
+        fds[i].fd = myClients[i].sock;
+        fds[i].events = POLLOUT;
+        fds[i].revents = 0;
+    }
+    fds.back().fd = myListenSocket;
+    fds.back().events = POLLIN;
+    fds.back().revents = 0;
+
+    if (poll(&fds[0], fds.size(), -1) == -1 && errno != EINTR) {
+        perror("OutputTcp");
+        throw std::runtime_error("OutputTcp::process unable to poll "
+                "clients!");
+    }
+}
+
+
+void OutputTcp::disconnect(size_t index, const char* reason)
+{
+    fprintf(stderr, "OutputTcp: client %s\n", reason);
+    close(myClients[index].sock);
+    myClients.erase(myClients.begin() + index);
+}
+
+
+int OutputTcp::process(Buffer* dataIn, Buffer* dataOut)
+{
+    PDEBUG("OutputTcp::process(%p, %p)\n", dataIn, dataOut);
+    assert(dataIn != NULL);
+
+    acceptClients(myClients.empty());
+
+    boost::shared_ptr<Buffer> frame(new Buffer(4 + dataIn->getLength()));
+    uint32_t length = htonl(dataIn->getLength());
+    memcpy(frame->getData(), &length, sizeof(length));
+    memcpy((char*)frame->getData() + 4, dataIn->getData(),
+            dataIn->getLength());
+    for (size_t i = 0; i < myClients.size(); ++i) {
+        myClients[i].frames.push_back(frame);
+    }
+
+    while (!myClients.empty()) {
+        size_t fastest = OUTPUT_TCP_MAX_QUEUED;
+        for (size_t i = 0; i < myClients.size(); ) {
+            if (sendQueued(myClients[i])) {
+                fastest = std::min(fastest, myClients[i].frames.size());
+                ++i;
+            }
+            else {
+                disconnect(i, "disconnected");
+            }
+        }
+        if (myClients.empty() || fastest < OUTPUT_TCP_MAX_QUEUED) {
+            break;
+        }
+        waitClients();
+        acceptClients(false);
+    }
+
+    // The fastest client sets the pace, the ones that cannot keep up with
+    // it are dropped
+    size_t fastest = 0;
+    for (size_t i = 0; i < myClients.size(); ++i) {
+        size_t queued = myClients[i].frames.size();
+        if (i == 0 || queued < fastest) {
+            fastest = queued;
+        }
+    }
+    for (size_t i = 0; i < myClients.size(); ) {
+        if (myClients[i].frames.size() > fastest + OUTPUT_TCP_MAX_BEHIND) {
+            disconnect(i, "too slow, disconnected");
+        }
+        else {
+            ++i;
+        }
+    }
+
+    return dataIn->getLength();
+}
@@ -0,0 +1,91 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OUTPUT_TCP_H
+#define OUTPUT_TCP_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModOutput.h"
+
+#include <boost/shared_ptr.hpp>
+#include <sys/types.h>
+#include <deque>
+#include <vector>
+
+
+/* Sends every frame to all connected TCP clients, prefixed with its
+ * length as a 32-bit big endian value. Used by the central instance of
+ * the split architecture to feed the OFDM heads.
+ *
+ * While no client is connected, process waits for one. The sockets do not
+ * block, each client has a queue of the frames it has not received yet.
+ * process only waits when even the fastest client has
+ * OUTPUT_TCP_MAX_QUEUED frames queued, so that a slow client does not
+ * hold up the others. A client that falls OUTPUT_TCP_MAX_BEHIND frames
+ * behind the fastest one, or fails to receive, is disconnected, and can
+ * connect again at any time.
+ */
+#define OUTPUT_TCP_MAX_QUEUED 10
+#define OUTPUT_TCP_MAX_BEHIND 50
+
+struct OutputTcpClient
+{
+    int sock;
+    // Length and contents of each frame, shared between the clients
+    std::deque<boost::shared_ptr<Buffer> > frames;
+    // Bytes of the first frame already sent
+    size_t offset;
+};
+
+class OutputTcp : public ModOutput
+{
+public:
+    OutputTcp(unsigned port);
+    virtual ~OutputTcp();
+    OutputTcp(const OutputTcp&);
+    OutputTcp& operator=(const OutputTcp&);
+
+    virtual int process(Buffer* dataIn, Buffer* dataOut);
+    const char* name() { return "OutputTcp"; }
+
+protected:
+    void acceptClients(bool wait);
+
+    /* Send as much of the queue of client as the socket takes without
+     * blocking. Returns false if the client has to be disconnected. */
+    bool sendQueued(OutputTcpClient& client);
+
+    /* Wait until one of the clients can receive more, or a new one
+     * connects */
+    void waitClients();
+
+    void disconnect(size_t index, const char* reason);
+
+    int myListenSocket;
+    std::vector<OutputTcpClient> myClients;
+};
+
+
+#endif // OUTPUT_TCP_H
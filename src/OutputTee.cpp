@@ -0,0 +1,146 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OutputTee.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdexcept>
+
+
+OutputTee::OutputTee(ModOutput* mainOutput) :
+    ModOutput(ModFormat(1), ModFormat(0)),
+    myMainOutput(mainOutput)
+{
+    PDEBUG("OutputTee::OutputTee(%s) @ %p\n", mainOutput->name(), this);
+}
+
+
+OutputTee::~OutputTee()
+{
+    PDEBUG("OutputTee::~OutputTee() @ %p\n", this);
+
+    // Let the sinks write out what they have queued
+    std::vector<TeeSink*>::iterator sink;
+    for (sink = mySinks.begin(); sink != mySinks.end(); ++sink) {
+        (*sink)->queue.push(boost::shared_ptr<Buffer>());
+    }
+    for (sink = mySinks.begin(); sink != mySinks.end(); ++sink) {
+        (*sink)->thread.join();
+        if ((*sink)->dropped) {
+            fprintf(stderr, "OutputTee: %s dropped %zu frames\n",
+                    (*sink)->output->name(), (*sink)->dropped);
+        }
+        delete (*sink)->output;
+        delete *sink;
+    }
+
+    delete myMainOutput;
+}
+
+
+TeePolicy OutputTee::parsePolicy(const std::string& policy)
+{
+    if (policy == "drop") {
+        return TEE_DROP;
+    }
+    else if (policy == "block") {
+        return TEE_BLOCK;
+    }
+    throw std::runtime_error("OutputTee: unknown queue policy " +
+            policy + "!");
+}
+
+
+void OutputTee::addSink(ModOutput* output, size_t maxQueued,
+        TeePolicy policy)
+{
+    if (maxQueued == 0) {
+        throw std::runtime_error("OutputTee::addSink queue size must "
+                "not be 0!");
+    }
+
+    TeeSink* sink = new TeeSink();
+    sink->output = output;
+    sink->maxQueued = maxQueued;
+    sink->policy = policy;
+    sink->dropped = 0;
+    sink->failed = false;
+    sink->thread = boost::thread(&OutputTee::sinkProcess, this, sink);
+    mySinks.push_back(sink);
+}
+
+
+void OutputTee::sinkProcess(TeeSink* sink)
+{
+    boost::shared_ptr<Buffer> frame;
+
+    while (true) {
+        sink->queue.wait_and_pop(frame);
+        if (!frame) {
+            break;
+        }
+        if (sink->failed) {
+            continue;
+        }
+
+        try {
+            sink->output->process(frame.get(), NULL);
+        }
+        catch (std::exception& e) {
+            fprintf(stderr, "OutputTee: %s failed, disabled: %s\n",
+                    sink->output->name(), e.what());
+            sink->failed = true;
+        }
+    }
+}
+
+
+int OutputTee::process(Buffer* dataIn, Buffer* dataOut)
+{
+    PDEBUG("OutputTee::process(%p, %p)\n", dataIn, dataOut);
+    assert(dataIn != NULL);
+
+    // The flowgraph reuses dataIn, the sinks share one copy of it
+    if (!mySinks.empty()) {
+        boost::shared_ptr<Buffer> frame(
+                new Buffer(dataIn->getLength(), dataIn->getData()));
+
+        std::vector<TeeSink*>::iterator sink;
+        for (sink = mySinks.begin(); sink != mySinks.end(); ++sink) {
+            if ((*sink)->policy == TEE_BLOCK) {
+                (*sink)->queue.push_wait_if_full(frame, (*sink)->maxQueued);
+            }
+            else if ((*sink)->queue.size() < (*sink)->maxQueued) {
+                (*sink)->queue.push(frame);
+            }
+            else {
+                if ((*sink)->dropped++ == 0) {
+                    fprintf(stderr, "OutputTee: %s too slow, "
+                            "dropping frames\n", (*sink)->output->name());
+                }
+            }
+        }
+    }
+
+    return myMainOutput->process(dataIn, dataOut);
+}
@@ -0,0 +1,93 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OUTPUT_TEE_H
+#define OUTPUT_TEE_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "ModOutput.h"
+#include "ThreadsafeQueue.h"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+
+enum TeePolicy {
+    // Discard the frame when the queue of the sink is full, never
+    // slows down the main output
+    TEE_DROP,
+    // Wait until the sink has room for the frame, no frame is lost
+    TEE_BLOCK,
+};
+
+
+struct TeeSink {
+    ModOutput* output;
+    size_t maxQueued;
+    TeePolicy policy;
+    // An empty pointer tells the worker to stop
+    ThreadsafeQueue<boost::shared_ptr<Buffer> > queue;
+    boost::thread thread;
+    size_t dropped;
+    // Set by the worker when the output failed, the sink then drops
+    // all further frames
+    bool failed;
+};
+
+
+/* Delivers every frame to a main output, and to any number of additional
+ * sinks. The main output runs in the caller, e.g. the UHD output that
+ * needs the timestamp of the current frame. The other sinks each have a
+ * worker thread and a queue, and all of them share one copy of the frame.
+ */
+class OutputTee : public ModOutput
+{
+public:
+    // Takes ownership of mainOutput
+    OutputTee(ModOutput* mainOutput);
+    virtual ~OutputTee();
+    OutputTee(const OutputTee&);
+    OutputTee& operator=(const OutputTee&);
+
+    // Takes ownership of output
+    void addSink(ModOutput* output, size_t maxQueued, TeePolicy policy);
+
+    static TeePolicy parsePolicy(const std::string& policy);
+
+    int process(Buffer* dataIn, Buffer* dataOut);
+    const char* name() { return "OutputTee"; }
+
+protected:
+    void sinkProcess(TeeSink* sink);
+
+    ModOutput* myMainOutput;
+    std::vector<TeeSink*> mySinks;
+};
+
+
+#endif // OUTPUT_TEE_H
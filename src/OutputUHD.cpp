@@ -206,6 +206,22 @@ OutputUHD::OutputUHD(
     uwd.logger = &myLogger;
     uwd.refclk_lock_loss_behaviour = myConf.refclk_lock_loss_behaviour;
 
+    switch (myConf.format) {
+    case FORMAT_COMPLEXF:
+        uwd.cpuFormat = "fc32";
+        break;
+    case FORMAT_SC16:
+        uwd.cpuFormat = "sc16";
+        break;
+    case FORMAT_SC8:
+        uwd.cpuFormat = "sc8";
+        break;
+    default:
+        throw std::runtime_error("OutputUHD: unsupported sample format " +
+                std::string(FormatConverter::formatName(myConf.format)));
+    }
+    uwd.sampleSize = FormatConverter::sampleSize(myConf.format);
+
 
     shared_ptr<barrier> b(new barrier(2));
     mySyncBarrier = b;
@@ -315,13 +331,13 @@ void UHDWorker::process()
     // Transmit timeout
     const double timeout = 0.2;
 
-    uhd::stream_args_t stream_args("fc32"); //complex floats
+    uhd::stream_args_t stream_args(uwd->cpuFormat);
     uhd::tx_streamer::sptr myTxStream = uwd->myUsrp->get_tx_stream(stream_args);
     size_t bufsize = myTxStream->get_max_num_samps();
 #endif
 
     bool check_refclk_loss = false;
-    const complexf* in;
+    const uint8_t* in;
 
     uhd::tx_metadata_t md;
     md.start_of_burst = false;
@@ -349,13 +365,13 @@ void UHDWorker::process()
                     "UHDWorker.process: workerbuffer is neither 0 nor 1 !");
         }
 
-        in = reinterpret_cast<const complexf*>(frame->buf);
+        in = reinterpret_cast<const uint8_t*>(frame->buf);
         pps_offset = frame->ts.timestamp_pps_offset;
 
         // Tx second from MNSC
         tx_second = frame->ts.timestamp_sec;
 
-        sizeIn = uwd->bufsize / sizeof(complexf);
+        sizeIn = uwd->bufsize / uwd->sampleSize;
 
 #if ENABLE_UHD
         // Check for ref_lock
@@ -477,7 +493,7 @@ void UHDWorker::process()
 
             //send a single packet
             size_t num_tx_samps = myTxStream->send(
-                    &in[num_acc_samps],
+                    &in[num_acc_samps * uwd->sampleSize],
                     samps_to_send, md, timeout);
 
             num_acc_samps += num_tx_samps;
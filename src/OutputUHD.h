@@ -54,6 +54,7 @@ DESCRIPTION:
 #include "EtiReader.h"
 #include "TimestampDecoder.h"
 #include "RemoteControl.h"
+#include "FormatConverter.h"
 
 #include <stdio.h>
 #include <sys/types.h>
@@ -105,6 +106,10 @@ struct UHDWorkerData {
     struct UHDWorkerFrameData frame1;
     size_t bufsize; // in bytes
 
+    // Host sample format given to the tx streamer
+    std::string cpuFormat;
+    size_t sampleSize; // in bytes
+
     // muting set by remote control
     bool muting;
 
@@ -170,6 +175,10 @@ struct OutputUHDConfig {
 
     /* What to do when the reference clock PLL loses lock */
     refclk_lock_loss_behaviour_t refclk_lock_loss_behaviour;
+
+    /* Host sample format, the FormatConverter in front of the
+     * output has to produce the same one */
+    SampleFormat format;
 };
 
 
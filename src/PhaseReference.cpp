@@ -26,10 +26,22 @@
 #include <stdexcept>
 #include <complex>
 #include <string.h>
+#include <map>
+#include <boost/thread/mutex.hpp>
 
 typedef std::complex<float> complexf;
 
 
+// The reference symbol only depends on the mode, the generators of all
+// modulators in the process share one symbol per mode.
+struct SharedSymbol {
+    complexf* data;
+    size_t users;
+};
+static std::map<unsigned int, SharedSymbol> sharedSymbols;
+static boost::mutex sharedSymbolsMutex;
+
+
 const unsigned char PhaseReference::d_h[4][32] = {
     { 0, 2, 0, 0, 0, 0, 1, 1, 2, 0, 0, 0, 2, 2, 1, 1,
         0, 2, 0, 0, 0, 0, 1, 1, 2, 0, 0, 0, 2, 2, 1, 1 },
@@ -71,8 +83,16 @@ PhaseReference::PhaseReference(unsigned int dabmode) :
         throw std::runtime_error(
                 "PhaseReference::PhaseReference DAB mode not valid!");
     }
-    d_dataIn = new complexf[d_num];
-    fillData();
+    {
+        boost::mutex::scoped_lock lock(sharedSymbolsMutex);
+        SharedSymbol& shared = sharedSymbols[d_dabmode];
+        if (shared.users++ == 0) {
+            d_dataIn = new complexf[d_num];
+            fillData();
+            shared.data = d_dataIn;
+        }
+        d_dataIn = shared.data;
+    }
 
     myOutputFormat.size(d_carriers * sizeof(complexf));
 }
@@ -82,7 +102,13 @@ PhaseReference::~PhaseReference()
 {
     PDEBUG("PhaseReference::~PhaseReference() @ %p\n", this);
 
-    delete[] d_dataIn;
+    boost::mutex::scoped_lock lock(sharedSymbolsMutex);
+    std::map<unsigned int, SharedSymbol>::iterator it =
+        sharedSymbols.find(d_dabmode);
+    if (it != sharedSymbols.end() && --it->second.users == 0) {
+        delete[] it->second.data;
+        sharedSymbols.erase(it);
+    }
 }
 
 
@@ -44,6 +44,7 @@ public:
 
     int process(Buffer* const dataIn, Buffer* dataOut);
     const char* name() { return "PhaseReference"; }
+    bool isConstant() { return true; }
 
 protected:
     unsigned int d_dabmode;
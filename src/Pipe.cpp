@@ -0,0 +1,69 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Pipe.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+bool isPipe(int fd)
+{
+    struct stat fileStat;
+    return fstat(fd, &fileStat) == 0 && S_ISFIFO(fileStat.st_mode);
+}
+
+
+size_t setPipeSize(int fd, size_t size)
+{
+    if (getPipeSize(fd) >= size) {
+        return getPipeSize(fd);
+    }
+
+    if (fcntl(fd, F_SETPIPE_SZ, (int)size) == -1) {
+        // Unprivileged processes are limited to pipe-max-size
+        unsigned long maxSize = 0;
+        FILE* file = fopen("/proc/sys/fs/pipe-max-size", "r");
+        if (file != NULL) {
+            if (fscanf(file, "%lu", &maxSize) != 1) {
+                maxSize = 0;
+            }
+            fclose(file);
+        }
+        if (maxSize > 0 && maxSize < size) {
+            fcntl(fd, F_SETPIPE_SZ, (int)maxSize);
+        }
+    }
+
+    size_t pipeSize = getPipeSize(fd);
+    PDEBUG("setPipeSize(%d, %zu): %zu\n", fd, size, pipeSize);
+    return pipeSize;
+}
+
+
+size_t getPipeSize(int fd)
+{
+    int size = fcntl(fd, F_GETPIPE_SZ);
+    return size > 0 ? size : 0;
+}
@@ -0,0 +1,52 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPE_H
+#define PIPE_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include <sys/types.h>
+
+
+/* Helpers for the input and output pipes, e.g. odr-dabmux | odr-dabmod.
+ * The pipe buffer is enlarged so that the other end can write or read in
+ * bursts without blocking us.
+ */
+
+// Size the pipe buffers are enlarged to, if the system allows it
+#define PIPE_BUFFER_SIZE (1024 * 1024)
+
+// Returns true if fd is a pipe or a FIFO
+bool isPipe(int fd);
+
+// Enlarges the buffer of the pipe to size bytes, or to the largest size
+// the system allows. Returns the size of the buffer, 0 on failure.
+size_t setPipeSize(int fd, size_t size);
+
+// Returns the size of the buffer of the pipe, 0 on failure
+size_t getPipeSize(int fd);
+
+
+#endif // PIPE_H
@@ -24,7 +24,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdexcept>
+#include <boost/thread/mutex.hpp>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+
+// DAB energy dispersal sequence, long enough for a whole CIF
+static std::vector<unsigned char> dabSequence;
+static boost::mutex dabSequenceMutex;
 
 
 PrbsGenerator::PrbsGenerator(size_t framesize, uint32_t polynomial,
@@ -41,6 +51,22 @@ PrbsGenerator::PrbsGenerator(size_t framesize, uint32_t polynomial,
 
     gen_prbs_table();
     gen_weight_table();
+
+    if (polynomial == 0x110 && accum == 0 && init == 0 &&
+            framesize <= 864 * 8) {
+        boost::mutex::scoped_lock lock(dabSequenceMutex);
+        if (dabSequence.empty()) {
+            dabSequence.resize(864 * 8);
+            gen_sequence(&dabSequence[0], dabSequence.size());
+        }
+        d_sequence = &dabSequence[0];
+    } else {
+        d_own_sequence.resize(framesize);
+        if (framesize) {
+            gen_sequence(&d_own_sequence[0], framesize);
+        }
+        d_sequence = framesize ? &d_own_sequence[0] : NULL;
+    }
 }
 
 
@@ -122,13 +148,8 @@ uint32_t PrbsGenerator::update_prbs()
 }
 
 
-int PrbsGenerator::process(Buffer* const dataIn, Buffer* dataOut)
+void PrbsGenerator::gen_sequence(unsigned char* out, size_t length)
 {
-    PDEBUG("PrbsGenerator::process(dataIn: %p, dataOut: %p)\n",
-            dataIn, dataOut);
-    dataOut->setLength(d_framesize);
-    unsigned char* out = reinterpret_cast<unsigned char*>(dataOut->getData());
-    
     // Initialization
     if (d_accum_init) {
         d_accum = d_accum_init;
@@ -142,11 +163,11 @@ int PrbsGenerator::process(Buffer* const dataIn, Buffer* dataOut)
     //PDEBUG("Polynomial: 0x%x\n", d_polynomial);
     //PDEBUG("Init accum: 0x%x\n", d_accum);
     size_t i = 0;
-    while (i < d_init) {
+    while (i < d_init && i < length) {
         out[i++] = 0xff;
     }
 
-    for (; i < d_framesize; ++i) {
+    for (; i < length; ++i) {
         // Writting data
         d_accum = update_prbs();
         if ((d_accum_init == 0xa9) && (i % 188 == 0)) { // DVB energy dispersal
@@ -156,6 +177,33 @@ int PrbsGenerator::process(Buffer* const dataIn, Buffer* dataOut)
         }
         //PDEBUG("accum: 0x%x\n", d_accum);
     }
+}
+
+
+void PrbsGenerator::mix(const unsigned char* in, unsigned char* out,
+        size_t length)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i]),
+                _mm_xor_si128(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i])),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&d_sequence[i]))));
+    }
+#endif
+    for (; i < length; ++i) {
+        out[i] = in[i] ^ d_sequence[i];
+    }
+}
+
+
+int PrbsGenerator::process(Buffer* const dataIn, Buffer* dataOut)
+{
+    PDEBUG("PrbsGenerator::process(dataIn: %p, dataOut: %p)\n",
+            dataIn, dataOut);
+    dataOut->setLength(d_framesize);
+    unsigned char* out = reinterpret_cast<unsigned char*>(dataOut->getData());
 
     if ((dataIn != NULL) && dataIn->getLength()) {
         PDEBUG(" mixing input\n");
@@ -165,10 +213,10 @@ int PrbsGenerator::process(Buffer* const dataIn, Buffer* dataOut)
             throw std::runtime_error("PrbsGenerator::process "
                     "input size is not equal to output size!\n");
         }
-        for (size_t i = 0; i < dataOut->getLength(); ++i) {
-            out[i] ^= in[i];
-        }
+        mix(in, out, d_framesize);
+    } else if (d_framesize) {
+        memcpy(out, d_sequence, d_framesize);
     }
-    
+
     return dataOut->getLength();
 }
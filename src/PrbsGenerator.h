@@ -31,6 +31,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <vector>
 
 
 class PrbsGenerator : public ModCodec
@@ -42,7 +43,8 @@ protected:
     void gen_prbs_table();
     uint32_t update_prbs();
     void gen_weight_table();
-    
+    void gen_sequence(unsigned char* out, size_t length);
+
     size_t d_framesize;
     // table of matrix products used to update a 32-bit PRBS generator
     uint32_t d_prbs_table [4][256];
@@ -57,6 +59,10 @@ protected:
     uint32_t d_accum_init;
     // Initialization size
     size_t d_init;
+    // Generated sequence, shared by all the generators with the DAB
+    // energy dispersal parameters
+    const unsigned char* d_sequence;
+    std::vector<unsigned char> d_own_sequence;
 
 public:
     PrbsGenerator(size_t framesize, uint32_t polynomial, uint32_t accum = 0,
@@ -65,6 +71,10 @@ public:
 
     int process(Buffer* const dataIn, Buffer* dataOut);
     const char* name() { return "PrbsGenerator"; }
+    bool isConstant() { return true; }
+
+    // XOR the first length bytes of the sequence with in
+    void mix(const unsigned char* in, unsigned char* out, size_t length);
 };
 
 
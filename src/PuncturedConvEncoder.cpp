@@ -0,0 +1,260 @@
+/*
+   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011 Her Majesty
+   the Queen in Right of Canada (Communications Research Center Canada)
+
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PuncturedConvEncoder.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <stdexcept>
+#include <boost/thread/once.hpp>
+
+
+const static unsigned char PARITY[] = {
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
+    0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0
+};
+
+
+// Encoder output for one input byte, indexed by the last 14 input bits:
+// the 6 bits of encoder memory followed by the new byte, oldest bit
+// first. The 32 output bits are stored with the first one in the MSB.
+static uint32_t ENCODE_TABLE[1 << 14];
+static boost::once_flag encodeTableOnce = BOOST_ONCE_INIT;
+
+
+static void fillEncodeTable()
+{
+    for (unsigned window = 0; window < (1 << 14); ++window) {
+        unsigned short memory = 0;
+        uint32_t code = 0;
+        for (int bit = 13; bit >= 0; --bit) {
+            memory >>= 1;
+            memory |= ((window >> bit) & 1) << 6;
+            if (bit < 8) {
+                code <<= 1;
+                code |= PARITY[memory & 0x5b];
+                code <<= 1;
+                code |= PARITY[memory & 0x79];
+                code <<= 1;
+                code |= PARITY[memory & 0x65];
+                code <<= 1;
+                code |= PARITY[memory & 0x5b];
+            }
+        }
+        ENCODE_TABLE[window] = code;
+    }
+}
+
+
+const uint32_t* PuncturedConvEncoder::encodeTable()
+{
+    // Modulators can be created from several threads at the same time
+    boost::call_once(encodeTableOnce, fillEncodeTable);
+    return ENCODE_TABLE;
+}
+
+
+PuncturedConvEncoder::PuncturedConvEncoder() :
+    ModCodec(ModFormat(0), ModFormat(0)),
+    d_in_block_size(0),
+    d_out_block_size(0),
+    d_has_tail(false),
+    d_encode_table(encodeTable())
+{
+    PDEBUG("PuncturedConvEncoder() @ %p\n", this);
+
+}
+
+
+PuncturedConvEncoder::~PuncturedConvEncoder()
+{
+    PDEBUG("PuncturedConvEncoder::~PuncturedConvEncoder() @ %p\n", this);
+
+}
+
+
+void PuncturedConvEncoder::compile_mask(PuncturingMask& mask,
+        uint32_t pattern)
+{
+    unsigned bits[4];
+    for (int k = 0; k < 4; ++k) {
+        uint8_t m = pattern >> (24 - 8 * k);
+        bits[k] = 0;
+        for (unsigned value = 0; value < 256; ++value) {
+            uint8_t kept = 0;
+            unsigned count = 0;
+            for (int j = 7; j >= 0; --j) {
+                if (m & (1 << j)) {
+                    kept = (kept << 1) | ((value >> j) & 1);
+                    ++count;
+                }
+            }
+            mask.extract[k][value] = kept;
+            bits[k] = count;
+        }
+    }
+    mask.shift[3] = 0;
+    for (int k = 2; k >= 0; --k) {
+        mask.shift[k] = mask.shift[k + 1] + bits[k + 1];
+    }
+    mask.bit_size = mask.shift[0] + bits[0];
+}
+
+
+static inline uint32_t puncture(const PuncturingMask& mask, uint32_t code)
+{
+    return ((uint32_t)mask.extract[0][code >> 24] << mask.shift[0]) |
+        ((uint32_t)mask.extract[1][(code >> 16) & 0xff] << mask.shift[1]) |
+        ((uint32_t)mask.extract[2][(code >> 8) & 0xff] << mask.shift[2]) |
+        mask.extract[3][code & 0xff];
+}
+
+
+void PuncturedConvEncoder::adjust_item_size()
+{
+    PDEBUG("PuncturedConvEncoder::adjust_item_size()\n");
+    size_t in_size = 0;
+    size_t out_size = 0;
+    std::vector<PuncturingMask>::const_iterator mask;
+
+    for (mask = d_masks.begin(); mask != d_masks.end(); ++mask) {
+        in_size += mask->in_length;
+        out_size += mask->in_length * mask->bit_size;
+    }
+    if (d_has_tail) {
+        out_size += d_tail_mask.bit_size;
+    }
+
+    d_in_block_size = in_size;
+    d_out_block_size = (out_size + 7) / 8;
+    myInputFormat.size(d_in_block_size);
+    myOutputFormat.size(d_out_block_size);
+
+    PDEBUG(" Punctured conv encoder ratio (out/in): %zu / %zu\n",
+            d_out_block_size, d_in_block_size);
+}
+
+
+void PuncturedConvEncoder::append_rule(const PuncturingRule& rule)
+{
+    PDEBUG("append_rule(rule(%zu, 0x%x))\n", rule.length(), rule.pattern());
+    if (rule.length() % 4 != 0) {
+        throw std::runtime_error(
+                "PuncturedConvEncoder::append_rule invalid rule length!");
+    }
+
+    // The rule length counts encoded bytes, 4 for each input byte
+    d_masks.push_back(PuncturingMask());
+    d_masks.back().in_length = rule.length() / 4;
+    compile_mask(d_masks.back(), rule.pattern());
+
+    adjust_item_size();
+}
+
+
+void PuncturedConvEncoder::append_tail_rule(const PuncturingRule& rule)
+{
+    PDEBUG("append_tail_rule(rule(%zu, 0x%x))\n", rule.length(), rule.pattern());
+    if (rule.length() != 3) {
+        throw std::runtime_error(
+                "PuncturedConvEncoder::append_tail_rule invalid rule length!");
+    }
+
+    // The 6 tail bits give 24 encoded bits, left aligned in the code word
+    d_tail_mask.in_length = 0;
+    compile_mask(d_tail_mask, rule.pattern() << 8);
+    d_has_tail = true;
+
+    adjust_item_size();
+}
+
+
+int PuncturedConvEncoder::process(Buffer* const dataIn, Buffer* dataOut)
+{
+    PDEBUG("PuncturedConvEncoder::process"
+            "(dataIn: %p, dataOut: %p)\n",
+            dataIn, dataOut);
+    PDEBUG(" in block size: %zu\n", d_in_block_size);
+    PDEBUG(" out block size: %zu\n", d_out_block_size);
+
+    if (dataIn->getLength() != d_in_block_size) {
+        throw std::runtime_error(
+                "PuncturedConvEncoder::process wrong input size");
+    }
+    dataOut->setLength(d_out_block_size);
+    encode(reinterpret_cast<const unsigned char*>(dataIn->getData()),
+            reinterpret_cast<unsigned char*>(dataOut->getData()));
+
+    return d_out_block_size;
+}
+
+
+void PuncturedConvEncoder::encode(const unsigned char* in,
+        unsigned char* out)
+{
+    unsigned short window = 0;
+    uint64_t bits = 0;
+    unsigned nb_bits = 0;
+    std::vector<PuncturingMask>::const_iterator mask;
+
+    for (mask = d_masks.begin(); mask != d_masks.end(); ++mask) {
+        for (size_t i = 0; i < mask->in_length; ++i) {
+            window = (window << 8) | *in++;
+            uint32_t code = d_encode_table[window & 0x3fff];
+            bits = (bits << mask->bit_size) | puncture(*mask, code);
+            nb_bits += mask->bit_size;
+            while (nb_bits >= 8) {
+                nb_bits -= 8;
+                *out++ = bits >> nb_bits;
+            }
+        }
+    }
+    if (d_has_tail) {
+        // Flush the encoder memory with zero bits
+        uint32_t code = d_encode_table[(window << 8) & 0x3fff];
+        bits = (bits << d_tail_mask.bit_size) | puncture(d_tail_mask, code);
+        nb_bits += d_tail_mask.bit_size;
+        while (nb_bits >= 8) {
+            nb_bits -= 8;
+            *out++ = bits >> nb_bits;
+        }
+    }
+    if (nb_bits) {
+        *out++ = bits << (8 - nb_bits);
+    }
+}
@@ -1,6 +1,9 @@
 /*
    Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011 Her Majesty
    the Queen in Right of Canada (Communications Research Center Canada)
+
+   Copyright (C) 2026
+   agent, agent@local
  */
 /*
    This file is part of ODR-DabMod.
@@ -19,8 +22,8 @@
    along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef PUNCTURING_ENCODER_H
-#define PUNCTURING_ENCODER_H
+#ifndef PUNCTURED_CONV_ENCODER_H
+#define PUNCTURED_CONV_ENCODER_H
 
 #ifdef HAVE_CONFIG_H
 #   include <config.h>
@@ -32,32 +35,55 @@
 
 #include <vector>
 #include <sys/types.h>
+#include <stdint.h>
+
+
+// Puncturing rule compiled for the 32 encoded bits of one input byte.
+// Each byte of the code word is compressed with a lookup table.
+struct PuncturingMask {
+    size_t in_length;
+    size_t bit_size;
+    unsigned shift[4];
+    uint8_t extract[4][256];
+};
 
 
-class PuncturingEncoder : public ModCodec
+// Convolutional encoder followed by puncturing, which only produces the
+// bits that survive the puncturing rules.
+class PuncturedConvEncoder : public ModCodec
 {
 private:
     size_t d_in_block_size;
     size_t d_out_block_size;
-    std::vector<PuncturingRule*> d_rules;
-    PuncturingRule* d_tail_rule;
+    std::vector<PuncturingMask> d_masks;
+    PuncturingMask d_tail_mask;
+    bool d_has_tail;
+    const uint32_t* d_encode_table;
 
 protected:
     void adjust_item_size();
+    static void compile_mask(PuncturingMask& mask, uint32_t pattern);
+
+    // 32 output bits for each value of the 6 memory bits followed by
+    // an input byte
+    static const uint32_t* encodeTable();
 
 public:
-    PuncturingEncoder();
-    virtual ~PuncturingEncoder();
-    PuncturingEncoder(const PuncturingEncoder&);
-    PuncturingEncoder& operator=(const PuncturingEncoder&);
-    
+    PuncturedConvEncoder();
+    virtual ~PuncturedConvEncoder();
+    PuncturedConvEncoder(const PuncturedConvEncoder&);
+    PuncturedConvEncoder& operator=(const PuncturedConvEncoder&);
+
     void append_rule(const PuncturingRule& rule);
     void append_tail_rule(const PuncturingRule& rule);
     int process(Buffer* const dataIn, Buffer* dataOut);
-    const char* name() { return "PuncturingEncoder"; }
+    const char* name() { return "PuncturedConvEncoder"; }
+
+    // Encode getInputSize() bytes from in to getOutputSize() bytes at out
+    void encode(const unsigned char* in, unsigned char* out);
     size_t getInputSize() { return d_in_block_size; }
     size_t getOutputSize() { return d_out_block_size; }
 };
 
 
-#endif // PUNCTURING_ENCODER_H
+#endif // PUNCTURED_CONV_ENCODER_H
@@ -33,6 +33,27 @@
 
 typedef std::complex<float> complexf;
 
+#ifdef __SSE__
+static const __m128 symbols[16] = {
+    _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
+    _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2)
+};
+#endif // __SSE__
+
 
 QpskSymbolMapper::QpskSymbolMapper(size_t carriers) :
     ModCodec(ModFormat(carriers / 4), ModFormat(carriers * 8)),
@@ -40,6 +61,23 @@ QpskSymbolMapper::QpskSymbolMapper(size_t carriers) :
 {
     PDEBUG("QpskSymbolMapper::QpskSymbolMapper(%zu) @ %p\n", carriers, this);
 
+    switch (carriers) {
+    case 1536:
+        d_mapSymbol = mapSymbol<1536>;
+        break;
+    case 384:
+        d_mapSymbol = mapSymbol<384>;
+        break;
+    case 192:
+        d_mapSymbol = mapSymbol<192>;
+        break;
+    case 768:
+        d_mapSymbol = mapSymbol<768>;
+        break;
+    default:
+        throw std::runtime_error("QpskSymbolMapper::QpskSymbolMapper "
+                "nb of carriers invalid!");
+    }
 }
 
 
@@ -50,6 +88,30 @@ QpskSymbolMapper::~QpskSymbolMapper()
 }
 
 
+#ifdef __SSE__
+template<size_t carriers>
+void QpskSymbolMapper::mapSymbol(const unsigned char* in, float* outData)
+{
+    __m128* out = reinterpret_cast<__m128*>(outData);
+    unsigned char tmp;
+    for (size_t j = 0; j < carriers / 8; ++j) {
+        tmp =  (in[j] & 0xc0) >> 4;
+        tmp |= (in[j + (carriers / 8)] & 0xc0) >> 6;
+        out[4 * j] = symbols[tmp];
+        tmp =  (in[j] & 0x30) >> 2;
+        tmp |= (in[j + (carriers / 8)] & 0x30) >> 4;
+        out[4 * j + 1] = symbols[tmp];
+        tmp =  (in[j] & 0x0c);
+        tmp |= (in[j + (carriers / 8)] & 0x0c) >> 2;
+        out[4 * j + 2] = symbols[tmp];
+        tmp =  (in[j] & 0x03) << 2;
+        tmp |= (in[j + (carriers / 8)] & 0x03);
+        out[4 * j + 3] = symbols[tmp];
+    }
+}
+#endif // __SSE__
+
+
 int QpskSymbolMapper::process(Buffer* const dataIn, Buffer* dataOut)
 {
     PDEBUG("QpskSymbolMapper::process"
@@ -59,7 +121,7 @@ int QpskSymbolMapper::process(Buffer* const dataIn, Buffer* dataOut)
     dataOut->setLength(dataIn->getLength() * 4 * 2 * sizeof(float));   // 4 output complex symbols per input byte
 #ifdef __SSE__
     const unsigned char* in = reinterpret_cast<const unsigned char*>(dataIn->getData());
-    __m128* out = reinterpret_cast<__m128*>(dataOut->getData());
+    float* out = reinterpret_cast<float*>(dataOut->getData());
 
     if (dataIn->getLength() % (d_carriers / 4) != 0) {
         fprintf(stderr, "%zu (input size) %% (%zu (carriers) / 4) != 0\n",
@@ -68,45 +130,10 @@ int QpskSymbolMapper::process(Buffer* const dataIn, Buffer* dataOut)
                 "QpskSymbolMapper::process input size not valid!");
     }
 
-    const static __m128 symbols[16] = {
-        _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps( M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2,  M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,  M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2, -M_SQRT1_2,  M_SQRT1_2),
-        _mm_setr_ps(-M_SQRT1_2,- M_SQRT1_2, -M_SQRT1_2, -M_SQRT1_2)
-    };
-    size_t inOffset = 0;
-    size_t outOffset = 0;
-    unsigned char tmp = 0;
     for (size_t i = 0; i < dataIn->getLength(); i += d_carriers / 4) {
-        for (size_t j = 0; j < d_carriers / 8; ++j) {
-            tmp =  (in[inOffset] & 0xc0) >> 4;
-            tmp |= (in[inOffset + (d_carriers / 8)] & 0xc0) >> 6;
-            out[outOffset] = symbols[tmp];
-            tmp =  (in[inOffset] & 0x30) >> 2;
-            tmp |= (in[inOffset + (d_carriers / 8)] & 0x30) >> 4;
-            out[outOffset + 1] = symbols[tmp];
-            tmp =  (in[inOffset] & 0x0c);
-            tmp |= (in[inOffset + (d_carriers / 8)] & 0x0c) >> 2;
-            out[outOffset + 2] = symbols[tmp];
-            tmp =  (in[inOffset] & 0x03) << 2;
-            tmp |= (in[inOffset + (d_carriers / 8)] & 0x03);
-            out[outOffset + 3] = symbols[tmp];
-            ++inOffset;
-            outOffset += 4;
-        }
-        inOffset += d_carriers / 8;
+        d_mapSymbol(in, out);
+        in += d_carriers / 4;
+        out += d_carriers * 2;
     }
 #else // !__SSE__
 #error "Code section not verified"
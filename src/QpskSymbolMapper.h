@@ -46,6 +46,11 @@ public:
 
 protected:
     size_t d_carriers;
+
+    // Maps one OFDM symbol, instantiated for the carriers of each mode
+    void (*d_mapSymbol)(const unsigned char* in, float* out);
+    template<size_t carriers>
+    static void mapSymbol(const unsigned char* in, float* out);
 };
 
 #endif // QPSK_SYMBOL_MAPPER_H
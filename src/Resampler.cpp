@@ -59,39 +59,44 @@ Resampler::Resampler(size_t inputRate, size_t outputRate, size_t resolution) :
 {
     PDEBUG("Resampler::Resampler(%zu, %zu) @ %p\n", inputRate, outputRate, this);
 
-    fprintf(stderr, "This software uses KISS FFT.\n\n");
-    fprintf(stderr, "Copyright (c) 2003-2004 Mark Borgerding\n"
-            "\n"
-            "All rights reserved.\n"
-            "\n"
-            "Redistribution and use in source and binary forms, with or "
-            "without modification, are permitted provided that the following "
-            "conditions are met:\n"
-            "\n"
-            "    * Redistributions of source code must retain the above "
-            "copyright notice, this list of conditions and the following "
-            "disclaimer.\n"
-            "    * Redistributions in binary form must reproduce the above "
-            "copyright notice, this list of conditions and the following "
-            "disclaimer in the documentation and/or other materials provided "
-            "with the distribution.\n"
-            "    * Neither the author nor the names of any contributors may be "
-            "used to endorse or promote products derived from this software "
-            "without specific prior written permission.\n"
-            "\n"
-            "THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND "
-            "CONTRIBUTORS \"AS IS\" AND ANY EXPRESS OR IMPLIED WARRANTIES, "
-            "INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF "
-            "MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE "
-            "DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS "
-            "BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, "
-            "EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED "
-            "TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, "
-            "DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON "
-            "ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, "
-            "OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY "
-            "OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE "
-            "POSSIBILITY OF SUCH DAMAGE.\n");
+    // The licence is shown once per process, not for every instance
+    static bool licenceShown = false;
+    if (!licenceShown) {
+        fprintf(stderr, "This software uses KISS FFT.\n\n");
+        fprintf(stderr, "Copyright (c) 2003-2004 Mark Borgerding\n"
+                "\n"
+                "All rights reserved.\n"
+                "\n"
+                "Redistribution and use in source and binary forms, with or "
+                "without modification, are permitted provided that the following "
+                "conditions are met:\n"
+                "\n"
+                "    * Redistributions of source code must retain the above "
+                "copyright notice, this list of conditions and the following "
+                "disclaimer.\n"
+                "    * Redistributions in binary form must reproduce the above "
+                "copyright notice, this list of conditions and the following "
+                "disclaimer in the documentation and/or other materials provided "
+                "with the distribution.\n"
+                "    * Neither the author nor the names of any contributors may be "
+                "used to endorse or promote products derived from this software "
+                "without specific prior written permission.\n"
+                "\n"
+                "THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND "
+                "CONTRIBUTORS \"AS IS\" AND ANY EXPRESS OR IMPLIED WARRANTIES, "
+                "INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF "
+                "MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE "
+                "DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS "
+                "BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, "
+                "EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED "
+                "TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, "
+                "DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON "
+                "ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, "
+                "OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY "
+                "OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE "
+                "POSSIBILITY OF SUCH DAMAGE.\n");
+        licenceShown = true;
+    }
 
     size_t divisor = gcd(inputRate, outputRate);
     L = outputRate / divisor;
@@ -0,0 +1,75 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_FRAME_H
+#define SPLIT_FRAME_H
+
+#ifdef HAVE_CONFIG_H
+#   include <config.h>
+#endif
+
+
+#include "Eti.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/* In the split architecture, a central instance does all the channel
+ * coding of an ETI frame, and sends the coded FIC and CIF to remote OFDM
+ * heads. A head only modulates them, and gets the fields of the ETI frame
+ * it needs for the frame phase and the timestamps along with them.
+ *
+ * Split frame format, one per ETI frame:
+ *   struct split_frame_header
+ *   uint8_t fic[ficSize]  coded FIC of the CIF
+ *   uint8_t cif[cifSize]  coded and time interleaved MSC
+ */
+enum SplitRole {
+    SPLIT_NONE,
+    // Channel coding only, the output is split frames
+    SPLIT_CENTRAL,
+    // OFDM modulation only, the input is split frames
+    SPLIT_HEAD,
+};
+
+#define SPLIT_FRAME_MAGIC 0x4f445346 // "ODSF"
+
+// The ETI frame was corrupted and the central instance uses crc=mute, the
+// heads transmit silence for it
+#define SPLIT_FRAME_MUTED 0x1
+
+struct split_frame_header {
+    uint32_t magic;
+    uint16_t ficSize;
+    uint16_t cifSize;
+    eti_FC fc;
+    eti_EOH eoh;
+    eti_TIST tist;
+    uint32_t flags;
+} PACKED;
+
+// Mode III has the largest FIC per CIF
+#define SPLIT_FRAME_MAX_SIZE \
+    (sizeof(struct split_frame_header) + 3072 / 8 + 864 * 8)
+
+
+#endif // SPLIT_FRAME_H
@@ -0,0 +1,73 @@
+/*
+   Copyright (C) 2026
+   agent, agent@local
+ */
+/*
+   This file is part of ODR-DabMod.
+
+   ODR-DabMod is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   ODR-DabMod is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SplitFrameEncoder.h"
+#include "PcDebug.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdexcept>
+#include <arpa/inet.h>
+
+
+SplitFrameEncoder::SplitFrameEncoder(EtiReader* etiReader) :
+    ModMux(ModFormat(0), ModFormat(0)),
+    myEtiReader(etiReader)
+{
+    PDEBUG("SplitFrameEncoder::SplitFrameEncoder(%p) @ %p\n",
+            etiReader, this);
+}
+
+
+SplitFrameEncoder::~SplitFrameEncoder()
+{
+    PDEBUG("SplitFrameEncoder::~SplitFrameEncoder() @ %p\n", this);
+}
+
+
+// dataIn[0] -> coded FIC
+// dataIn[1] -> CIF
+int SplitFrameEncoder::process(std::vector<Buffer*> dataIn, Buffer* dataOut)
+{
+    PDEBUG("SplitFrameEncoder::process(dataIn: %zu, dataOut: %p)\n",
+            dataIn.size(), dataOut);
+
+    if (dataIn.size() != 2) {
+        throw std::runtime_error(
+                "SplitFrameEncoder::process nb of input streams not 2!");
+    }
+
+    size_t ficSize = dataIn[0]->getLength();
+    size_t cifSize = dataIn[1]->getLength();
+
+    struct split_frame_header header;
+    myEtiReader->getSplitHeader(header);
+    header.ficSize = htons(ficSize);
+    header.cifSize = htons(cifSize);
+
+    dataOut->setLength(sizeof(header) + ficSize + cifSize);
+    unsigned char* out = reinterpret_cast<unsigned char*>(dataOut->getData());
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), dataIn[0]->getData(), ficSize);
+    memcpy(out + sizeof(header) + ficSize, dataIn[1]->getData(), cifSize);
+
+    return dataOut->getLength();
+}
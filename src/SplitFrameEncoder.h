@@ -1,6 +1,6 @@
 /*
-   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011 Her Majesty
-   the Queen in Right of Canada (Communications Research Center Canada)
+   Copyright (C) 2026
+   agent, agent@local
  */
 /*
    This file is part of ODR-DabMod.
@@ -19,32 +19,38 @@
    along with ODR-DabMod.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef CONV_ENCODER_H
-#define CONV_ENCODER_H
+#ifndef SPLIT_FRAME_ENCODER_H
+#define SPLIT_FRAME_ENCODER_H
 
 #ifdef HAVE_CONFIG_H
 #   include <config.h>
 #endif
 
 
-#include "ModCodec.h"
+#include "ModMux.h"
+#include "EtiReader.h"
+#include "SplitFrame.h"
 
 #include <sys/types.h>
+#include <vector>
 
 
-class ConvEncoder : public ModCodec
+// Packs the coded FIC and CIF of one ETI frame into a split frame for
+// the remote OFDM heads
+class SplitFrameEncoder : public ModMux
 {
-private:
-    size_t d_framesize;
+public:
+    SplitFrameEncoder(EtiReader* etiReader);
+    virtual ~SplitFrameEncoder();
+    SplitFrameEncoder(const SplitFrameEncoder&);
+    SplitFrameEncoder& operator=(const SplitFrameEncoder&);
+
+    int process(std::vector<Buffer*> dataIn, Buffer* dataOut);
+    const char* name() { return "SplitFrameEncoder"; }
 
 protected:
-    
-public:
-    ConvEncoder(size_t framesize);
-    virtual ~ConvEncoder();
-    int process(Buffer* const dataIn, Buffer* dataOut);
-    const char* name() { return "ConvEncoder"; }
+    EtiReader* myEtiReader;
 };
 
 
-#endif // CONV_ENCODER_H
+#endif // SPLIT_FRAME_ENCODER_H
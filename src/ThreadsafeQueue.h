@@ -73,11 +73,38 @@ public:
         return queue_size;
     }
 
+    /* Push one element into the queue, but wait until it contains
+     * less than max_size elements.
+     *
+     * returns the new queue size.
+     */
+    size_t push_wait_if_full(T const& val, size_t max_size)
+    {
+        boost::mutex::scoped_lock lock(the_mutex);
+        while(the_queue.size() >= max_size)
+        {
+            the_pop_notification.wait(lock);
+        }
+        the_queue.push(val);
+        size_t queue_size = the_queue.size();
+        lock.unlock();
+
+        notify();
+
+        return queue_size;
+    }
+
     void notify()
     {
         the_condition_variable.notify_one();
     }
 
+    size_t size() const
+    {
+        boost::mutex::scoped_lock lock(the_mutex);
+        return the_queue.size();
+    }
+
     bool empty() const
     {
         boost::mutex::scoped_lock lock(the_mutex);
@@ -94,6 +121,9 @@ public:
 
         popped_value = the_queue.front();
         the_queue.pop();
+        lock.unlock();
+
+        the_pop_notification.notify_one();
         return true;
     }
 
@@ -107,12 +137,16 @@ public:
 
         popped_value = the_queue.front();
         the_queue.pop();
+        lock.unlock();
+
+        the_pop_notification.notify_one();
     }
 
 private:
     std::queue<T> the_queue;
     mutable boost::mutex the_mutex;
     boost::condition_variable the_condition_variable;
+    boost::condition_variable the_pop_notification;
     size_t the_required_size;
 };
 
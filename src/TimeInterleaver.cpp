@@ -23,23 +23,34 @@
 #include "PcDebug.h"
 
 #include <vector>
+#include <string.h>
 #include <stdint.h>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+
+// Bit taken from the frame with delay d, for even and odd output bytes
+static const unsigned char DELAY_MASK[2][16] = {
+    {   0x80, 0x00, 0x08, 0x00, 0x20, 0x00, 0x02, 0x00,
+        0x40, 0x00, 0x04, 0x00, 0x10, 0x00, 0x01, 0x00 },
+    {   0x00, 0x80, 0x00, 0x08, 0x00, 0x20, 0x00, 0x02,
+        0x00, 0x40, 0x00, 0x04, 0x00, 0x10, 0x00, 0x01 }
+};
 
 
 TimeInterleaver::TimeInterleaver(size_t framesize)
     throw (std::invalid_argument) :
         ModCodec(ModFormat(framesize), ModFormat(framesize)),
-        d_framesize(framesize)
+        d_framesize(framesize),
+        d_history(16 * framesize, 0),
+        d_head(0)
 {
     PDEBUG("TimeInterleaver::TimeInterleaver(%zu) @ %p\n", framesize, this);
 
     if (framesize & 1) {
         throw std::invalid_argument("framesize must be 16 bits multiple");
     }
-    for (int i = 0; i < 16; ++i) {
-        std::vector<unsigned char> data(framesize, 0);
-        d_history.push_back(data);
-    }
 }
 
 
@@ -58,35 +69,44 @@ int TimeInterleaver::process(Buffer* const dataIn, Buffer* dataOut)
     const unsigned char* in = reinterpret_cast<const unsigned char*>(dataIn->getData());
     unsigned char* out = reinterpret_cast<unsigned char*>(dataOut->getData());
 
-    
-    for (size_t i = 0; i < dataOut->getLength();) {
-        d_history.push_front(d_history.back());
-        d_history.pop_back();
-        for (uint_fast16_t j = 0; j < d_framesize;) {
-            d_history[0][j] = in[i];
-            out[i]  = d_history[0] [j] & 0x80;
-            out[i] |= d_history[8] [j] & 0x40;
-            out[i] |= d_history[4] [j] & 0x20;
-            out[i] |= d_history[12][j] & 0x10;
-            out[i] |= d_history[2] [j] & 0x08;
-            out[i] |= d_history[10][j] & 0x04;
-            out[i] |= d_history[6] [j] & 0x02;
-            out[i] |= d_history[14][j] & 0x01;
-            ++i;
-            ++j;
-            d_history[0][j] = in[i];
-            out[i]  = d_history[1] [j] & 0x80;
-            out[i] |= d_history[9] [j] & 0x40;
-            out[i] |= d_history[5] [j] & 0x20;
-            out[i] |= d_history[13][j] & 0x10;
-            out[i] |= d_history[3] [j] & 0x08;
-            out[i] |= d_history[11][j] & 0x04;
-            out[i] |= d_history[7] [j] & 0x02;
-            out[i] |= d_history[15][j] & 0x01;
-            ++i;
-            ++j;
+    for (size_t i = 0; i < dataOut->getLength(); i += d_framesize) {
+        // The oldest frame is replaced by the new one
+        d_head = (d_head + 15) & 15;
+        memcpy(&d_history[d_head * d_framesize], &in[i], d_framesize);
+
+        const unsigned char* rows[16];
+        for (int d = 0; d < 16; ++d) {
+            rows[d] = &d_history[((d_head + d) & 15) * d_framesize];
+        }
+
+        size_t j = 0;
+#ifdef __SSE2__
+        // Each output byte takes one bit of 8 delayed frames, even and
+        // odd bytes from even and odd delays respectively
+        __m128i masks[16];
+        for (int d = 0; d < 16; ++d) {
+            masks[d] = _mm_set1_epi16(
+                    DELAY_MASK[0][d] | (DELAY_MASK[1][d] << 8));
+        }
+        for (; j + 16 <= d_framesize; j += 16) {
+            __m128i acc = _mm_setzero_si128();
+            for (int d = 0; d < 16; ++d) {
+                __m128i row = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(&rows[d][j]));
+                acc = _mm_or_si128(acc, _mm_and_si128(row, masks[d]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i + j]), acc);
+        }
+#endif
+        for (; j < d_framesize; ++j) {
+            const unsigned char* mask = DELAY_MASK[j & 1];
+            unsigned char data = 0;
+            for (int d = 0; d < 16; ++d) {
+                data |= rows[d][j] & mask[d];
+            }
+            out[i + j] = data;
         }
     }
-    
+
     return dataOut->getLength();
 }
@@ -30,7 +30,6 @@
 #include "ModCodec.h"
 
 #include <vector>
-#include <deque>
 #include <stdexcept>
 #include <sys/types.h>
 
@@ -41,7 +40,9 @@ private:
 
 protected:
     size_t d_framesize;
-    std::deque<std::vector<unsigned char> > d_history;
+    // Ring of the last 16 frames, d_history[d_head] is the newest one
+    std::vector<unsigned char> d_history;
+    size_t d_head;
 
 public:
     TimeInterleaver(size_t framesize) throw (std::invalid_argument);